@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions so that allocations can be counted while profiling.
+// Replacement functions may not be inline, so this header must be included by exactly one
+// translation unit per executable.
+
+namespace cppwin32
+{
+    inline std::atomic<bool> count_allocations{};
+    inline std::atomic<uint64_t> allocation_count{};
+
+    inline void* counted_allocate(size_t size, size_t const alignment)
+    {
+        if (count_allocations.load(std::memory_order_relaxed))
+        {
+            allocation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (size == 0)
+        {
+            size = 1;
+        }
+
+        void* result{};
+
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            result = std::malloc(size);
+        }
+        else
+        {
+#ifdef _WIN32
+            result = _aligned_malloc(size, alignment);
+#else
+            // aligned_alloc requires the size to be a multiple of the alignment.
+            result = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+        }
+
+        if (!result)
+        {
+            throw std::bad_alloc{};
+        }
+
+        return result;
+    }
+
+    inline void counted_free(void* pointer, size_t const alignment) noexcept
+    {
+#ifdef _WIN32
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            _aligned_free(pointer);
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        std::free(pointer);
+    }
+}
+
+void* operator new(size_t size)
+{
+    return cppwin32::counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](size_t size)
+{
+    return cppwin32::counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return cppwin32::counted_allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return cppwin32::counted_allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept
+{
+    try
+    {
+        return cppwin32::counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, std::nothrow_t const&) noexcept
+{
+    try
+    {
+        return cppwin32::counted_allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+// GCC warns that free is called on memory from operator new once these are inlined into their
+// callers, not knowing that the operator new above is the matching malloc.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* pointer) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* pointer, std::nothrow_t const&) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete[](void* pointer, std::nothrow_t const&) noexcept
+{
+    cppwin32::counted_free(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+    cppwin32::counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+    cppwin32::counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    cppwin32::counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    cppwin32::counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
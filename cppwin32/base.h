@@ -187,6 +187,9 @@ namespace win32::_impl_
         return static_cast<std::underlying_type_t<T>>(value);
     }
 
+    template <typename T>
+    inline constexpr bool is_flags_v = false;
+
     template <typename, typename = std::void_t<>>
     struct is_implements : std::false_type {};
 
@@ -254,6 +257,57 @@ WIN32_EXPORT namespace win32
     }
 }
 
+// Operators for enums with the FlagsAttribute, which -flags enables by specializing
+// _impl_::is_flags_v. A namespace with such enums brings these into scope with using-declarations
+// so that lookup finds them.
+WIN32_EXPORT namespace win32
+{
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator|(T const left, T const right) noexcept
+    {
+        return static_cast<T>(_impl_::to_underlying_type(left) | _impl_::to_underlying_type(right));
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator|=(T& left, T const right) noexcept
+    {
+        left = left | right;
+        return left;
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator&(T const left, T const right) noexcept
+    {
+        return static_cast<T>(_impl_::to_underlying_type(left) & _impl_::to_underlying_type(right));
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator&=(T& left, T const right) noexcept
+    {
+        left = left & right;
+        return left;
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator~(T const value) noexcept
+    {
+        return static_cast<T>(~_impl_::to_underlying_type(value));
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator^(T const left, T const right) noexcept
+    {
+        return static_cast<T>(_impl_::to_underlying_type(left) ^ _impl_::to_underlying_type(right));
+    }
+
+    template <typename T, std::enable_if_t<_impl_::is_flags_v<T>, int> = 0>
+    constexpr auto operator^=(T& left, T const right) noexcept
+    {
+        left = left ^ right;
+        return left;
+    }
+}
+
 namespace win32::_impl_
 {
     template <typename T>
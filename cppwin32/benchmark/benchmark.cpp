@@ -0,0 +1,654 @@
+// Microbenchmarks for the winmd reader and the header writers. Each benchmark is run until a
+// sample is long enough to time reliably and the median of several samples is reported, along
+// with the number of heap allocations per operation.
+//
+//   benchmark [-save <file>] [-baseline <file>] [-tolerance <percent>] [-filter <name>] <winmd>...
+//
+// -save writes the results as JSON. -baseline compares against a file written by -save and
+// fails if any benchmark is slower, or allocates more, than the baseline plus the tolerance
+// (10% by default).
+//
+// The projection is header-only, so on Linux the benchmark builds from the repo root with the
+// command below. GCC needs -fpermissive as the reader names members after their types.
+//
+//   g++ -std=c++20 -O2 -fpermissive -pthread -Icppwin32 -Icppwin32/winmd -DCPPWIN32_VERSION_STRING='"0.0.0.1"' cppwin32/benchmark/benchmark.cpp -o benchmark
+
+#include <winmd_reader.h>
+
+namespace cppwin32
+{
+    // cmd_reader.h is Windows-only, so the writers use the reader's throw_invalid here.
+    using winmd::impl::throw_invalid;
+}
+
+#include "settings.h"
+#include "manifest.h"
+#include "task_group.h"
+#include "text_writer.h"
+#include "profiler.h"
+#include "report.h"
+#include "type_dependency_graph.h"
+#include "type_writers.h"
+#include "code_writers.h"
+#include "file_writers.h"
+#include "allocation_counter.h"
+
+namespace cppwin32
+{
+    settings_type settings;
+    generation_manifest manifest;
+    profiler profile;
+    header_report report;
+}
+
+namespace cppwin32::benchmark
+{
+    using namespace std::literals;
+    using clock = std::chrono::steady_clock;
+
+    struct result
+    {
+        std::string name;
+        double ns_per_op{};
+        double allocs_per_op{};
+    };
+
+    struct options
+    {
+        std::vector<std::string> files;
+        std::string save;
+        std::string baseline;
+        std::string filter;
+        double tolerance{ 10 };
+    };
+
+    // Keeps the optimizer from discarding the work being measured.
+    uint64_t sink{};
+
+    struct runner
+    {
+        explicit runner(std::string const& filter) : m_filter(filter)
+        {
+        }
+
+        // The body performs ops operations per call.
+        template <typename F>
+        void run(std::string_view const& name, uint64_t const ops, F&& body)
+        {
+            if (ops == 0 || (!m_filter.empty() && name.find(m_filter) == std::string_view::npos))
+            {
+                return;
+            }
+
+            constexpr size_t sample_count = 9;
+            constexpr auto min_sample = std::chrono::milliseconds(20);
+
+            body();
+            uint64_t repeat = 1;
+
+            while (true)
+            {
+                auto const start = clock::now();
+
+                for (uint64_t i{}; i != repeat; ++i)
+                {
+                    body();
+                }
+
+                if (clock::now() - start >= min_sample)
+                {
+                    break;
+                }
+
+                repeat *= 2;
+            }
+
+            std::array<double, sample_count> samples{};
+
+            for (auto&& sample : samples)
+            {
+                auto const start = clock::now();
+
+                for (uint64_t i{}; i != repeat; ++i)
+                {
+                    body();
+                }
+
+                auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+                sample = elapsed / static_cast<double>(repeat * ops);
+            }
+
+            std::nth_element(samples.begin(), samples.begin() + sample_count / 2, samples.end());
+
+            // Allocations are counted in a separate pass so the counter doesn't perturb the timings.
+            auto const allocations = allocation_count.load();
+            count_allocations = true;
+            body();
+            count_allocations = false;
+
+            m_results.push_back({
+                std::string{ name },
+                samples[sample_count / 2],
+                static_cast<double>(allocation_count - allocations) / static_cast<double>(ops) });
+        }
+
+        std::vector<result> const& results() const noexcept
+        {
+            return m_results;
+        }
+
+    private:
+
+        std::string m_filter;
+        std::vector<result> m_results;
+    };
+
+    static options parse_options(int const argc, char** argv)
+    {
+        options result;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view const arg{ argv[i] };
+
+            auto value = [&]() -> std::string
+            {
+                if (++i == argc)
+                {
+                    throw_invalid("Option '", arg, "' requires a value");
+                }
+
+                return argv[i];
+            };
+
+            if (arg == "-save")
+            {
+                result.save = value();
+            }
+            else if (arg == "-baseline")
+            {
+                result.baseline = value();
+            }
+            else if (arg == "-filter")
+            {
+                result.filter = value();
+            }
+            else if (arg == "-tolerance")
+            {
+                result.tolerance = std::stod(value());
+            }
+            else if (!arg.empty() && arg[0] == '-')
+            {
+                throw_invalid("Option '", arg, "' is not supported");
+            }
+            else
+            {
+                result.files.emplace_back(arg);
+            }
+        }
+
+        if (result.files.empty())
+        {
+            throw_invalid("No metadata files specified");
+        }
+
+        return result;
+    }
+
+    template <typename F>
+    static uint64_t for_each_row(cache const& c, F&& callback)
+    {
+        uint64_t count{};
+
+        for (auto&& db : c.databases())
+        {
+            count += callback(db);
+        }
+
+        return count;
+    }
+
+    // Compares the type index against nested maps at roughly the scale of the full SDK
+    // metadata, independent of the files being benchmarked.
+    static void run_index_benchmarks(runner& r)
+    {
+        std::vector<std::string> namespaces;
+        std::vector<std::string> names;
+
+        for (uint32_t i{}; i != 300; ++i)
+        {
+            namespaces.push_back("Windows.Win32.Subsystem" + std::to_string(i * 7919 % 1000) + ".Area");
+        }
+
+        for (uint32_t i{}; i != 100; ++i)
+        {
+            names.push_back("TYPE_NAME_" + std::to_string(i * 31 % 977) + "_EX");
+        }
+
+        std::map<std::string_view, std::map<std::string_view, TypeDef>> map;
+        std::vector<type_index::entry> entries;
+
+        for (auto&& ns : namespaces)
+        {
+            for (auto&& name : names)
+            {
+                map[ns][name] = {};
+                entries.push_back({ ns, name, {} });
+            }
+        }
+
+        type_index index;
+        index.assign(std::move(entries));
+        std::vector<std::pair<std::string_view, std::string_view>> queries;
+
+        for (uint32_t i{}; i != 30000; ++i)
+        {
+            queries.emplace_back(namespaces[i * 13 % namespaces.size()], names[i * 17 % names.size()]);
+        }
+
+        r.run("synthetic find (map)", queries.size(), [&]
+            {
+                for (auto&& [ns, name] : queries)
+                {
+                    auto outer = map.find(ns);
+                    sink += outer->second.find(name) != outer->second.end() ? 1 : 0;
+                }
+            });
+
+        r.run("synthetic find (type_index)", queries.size(), [&]
+            {
+                for (auto&& [ns, name] : queries)
+                {
+                    sink += index.find(ns, name).index();
+                }
+            });
+    }
+
+    static void run_benchmarks(runner& r, std::vector<std::string> const& files)
+    {
+        run_index_benchmarks(r);
+
+        r.run("cache", 1, [&]
+            {
+                cache c{ files };
+                sink += c.namespaces().size();
+            });
+
+        cache c{ files };
+
+        auto const type_count = for_each_row(c, [](database const& db) { return db.TypeDef.size(); });
+        auto const type_ref_count = for_each_row(c, [](database const& db) { return db.TypeRef.size(); });
+        auto const method_count = for_each_row(c, [](database const& db) { return db.MethodDef.size(); });
+        uint64_t name_count{};
+
+        for (auto&& [ns, members] : c.namespaces())
+        {
+            name_count += members.types.size();
+        }
+
+        // Only the types the cache indexes can be categorized; that excludes <Module>.
+        r.run("get_category", name_count, [&]
+            {
+                for (auto&& [ns, members] : c.namespaces())
+                {
+                    for (auto&& [name, type] : members.types)
+                    {
+                        sink += static_cast<uint64_t>(get_category(type));
+                    }
+                }
+            });
+
+        r.run("cache::find", name_count, [&]
+            {
+                for (auto&& [ns, members] : c.namespaces())
+                {
+                    for (auto&& [name, type] : members.types)
+                    {
+                        sink += c.find(ns, name) ? 1 : 0;
+                    }
+                }
+            });
+
+        // The nested map lookup that cache::find used before the hash index, for comparison.
+        r.run("cache::find (map)", name_count, [&]
+            {
+                for (auto&& [ns, members] : c.namespaces())
+                {
+                    for (auto&& [name, type] : members.types)
+                    {
+                        auto outer = c.namespaces().find(ns);
+                        sink += outer->second.types.find(name) != outer->second.types.end() ? 1 : 0;
+                    }
+                }
+            });
+
+        std::vector<std::string> full_names;
+
+        for (auto&& [ns, members] : c.namespaces())
+        {
+            for (auto&& [name, type] : members.types)
+            {
+                full_names.push_back(std::string{ ns } + "." + std::string{ name });
+            }
+        }
+
+        r.run("cache::find(full name)", full_names.size(), [&]
+            {
+                for (auto&& name : full_names)
+                {
+                    sink += c.find(name) ? 1 : 0;
+                }
+            });
+
+        r.run("find(TypeRef)", type_ref_count, [&]
+            {
+                for_each_row(c, [](database const& db)
+                    {
+                        for (auto&& type : db.TypeRef)
+                        {
+                            sink += find(type) ? 1 : 0;
+                        }
+
+                        return 0;
+                    });
+            });
+
+        uint64_t nested_ref_count{};
+
+        for_each_row(c, [&](database const& db)
+            {
+                for (auto&& type : db.TypeRef)
+                {
+                    nested_ref_count += type.ResolutionScope().type() == ResolutionScope::TypeRef ? 1 : 0;
+                }
+
+                return 0;
+            });
+
+        if (nested_ref_count)
+        {
+            r.run("find(nested TypeRef)", nested_ref_count, [&]
+                {
+                    for_each_row(c, [](database const& db)
+                        {
+                            for (auto&& type : db.TypeRef)
+                            {
+                                if (type.ResolutionScope().type() == ResolutionScope::TypeRef)
+                                {
+                                    sink += find(type) ? 1 : 0;
+                                }
+                            }
+
+                            return 0;
+                        });
+                });
+        }
+
+        r.run("nested_types", type_count, [&]
+            {
+                for_each_row(c, [&](database const& db)
+                    {
+                        for (auto&& type : db.TypeDef)
+                        {
+                            sink += c.nested_types(type).size();
+                        }
+
+                        return 0;
+                    });
+            });
+
+        r.run("get_attribute", type_count, [&]
+            {
+                for_each_row(c, [](database const& db)
+                    {
+                        for (auto&& type : db.TypeDef)
+                        {
+                            sink += get_attribute(type, "System.Runtime.InteropServices"sv, "GuidAttribute"sv) ? 1 : 0;
+                        }
+
+                        return 0;
+                    });
+            });
+
+        auto const guid_attribute = intern_attribute("System.Runtime.InteropServices"sv, "GuidAttribute"sv);
+
+        r.run("find_attribute", type_count, [&]
+            {
+                for_each_row(c, [&](database const& db)
+                    {
+                        for (auto&& type : db.TypeDef)
+                        {
+                            sink += find_attribute(type, guid_attribute) ? 1 : 0;
+                        }
+
+                        return 0;
+                    });
+            });
+
+        r.run("get_string", method_count, [&]
+            {
+                for_each_row(c, [](database const& db)
+                    {
+                        for (auto&& method : db.MethodDef)
+                        {
+                            sink += method.Name().size();
+                        }
+
+                        return 0;
+                    });
+            });
+
+        // A database outside a cache has no atoms, so get_string scans for the terminator.
+        std::list<database> standalone;
+
+        for (auto&& file : files)
+        {
+            standalone.emplace_back(file);
+        }
+
+        r.run("get_string (no atoms)", method_count, [&]
+            {
+                for (auto&& db : standalone)
+                {
+                    for (auto&& method : db.MethodDef)
+                    {
+                        sink += method.Name().size();
+                    }
+                }
+            });
+
+        std::vector<TypeDef> types;
+
+        for_each_row(c, [&](database const& db)
+            {
+                types.insert(types.end(), db.TypeDef.begin(), db.TypeDef.end());
+                return 0;
+            });
+
+        r.run("sort by name (atoms)", types.size(), [&]
+            {
+                auto sorted = types;
+                std::sort(sorted.begin(), sorted.end(), writer::depends_compare{});
+                sink += sorted.front().index();
+            });
+
+        r.run("sort by name (strings)", types.size(), [&]
+            {
+                auto sorted = types;
+                std::sort(sorted.begin(), sorted.end(), [](TypeDef const& left, TypeDef const& right)
+                    {
+                        return left.TypeName() < right.TypeName();
+                    });
+                sink += sorted.front().index();
+            });
+
+        r.run("method_signature", method_count, [&]
+            {
+                for_each_row(c, [](database const& db)
+                    {
+                        for (auto&& method : db.MethodDef)
+                        {
+                            method_signature signature{ method };
+                            sink += signature.params().size();
+                        }
+
+                        return 0;
+                    });
+            });
+
+        auto write_all = [&](std::string_view const& name, auto&& write)
+        {
+            r.run(name, c.namespaces().size(), [&]
+                {
+                    for (auto&& [ns, members] : c.namespaces())
+                    {
+                        writer w;
+                        write(w, ns, members);
+                        sink += w.size();
+                    }
+                });
+        };
+
+        r.run("definition units", c.namespaces().size(), [&]
+            {
+                sink += get_struct_units(c.namespaces()).units.size();
+                sink += get_interface_units(c.namespaces()).units.size();
+            });
+
+        auto const structs = get_struct_units(c.namespaces());
+        auto const interfaces = get_interface_units(c.namespaces());
+
+        write_all("write_namespace_0_h", [](writer& w, auto&& ns, auto&& members) { write_namespace_0_h(w, ns, members); });
+        write_all("write_namespace_1_h", [&](writer& w, auto&& ns, auto&& members) { write_namespace_1_h(w, ns, members, structs); });
+        write_all("write_namespace_2_h", [&](writer& w, auto&& ns, auto&& members) { write_namespace_2_h(w, ns, members, interfaces); });
+        write_all("write_namespace_h", [](writer& w, auto&& ns, auto&& members) { write_namespace_h(w, ns, members); });
+    }
+
+    static void save_results(std::string const& filename, std::vector<result> const& results)
+    {
+        writer w;
+        w.write("{\n    \"benchmarks\": [\n");
+
+        for (size_t i{}; i != results.size(); ++i)
+        {
+            w.write_printf("        { \"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f }%s\n",
+                results[i].name.c_str(),
+                results[i].ns_per_op,
+                results[i].allocs_per_op,
+                i + 1 == results.size() ? "" : ",");
+        }
+
+        w.write("    ]\n}\n");
+        w.flush_to_file(filename);
+    }
+
+    // Reads the one-benchmark-per-line layout written by save_results.
+    static std::map<std::string, result> load_results(std::string const& filename)
+    {
+        std::ifstream file{ filename };
+
+        if (!file)
+        {
+            throw_invalid("Could not open baseline '", filename, "'");
+        }
+
+        std::map<std::string, result> results;
+        std::string line;
+
+        auto field = [&](std::string_view const& name) -> std::string_view
+        {
+            auto const key = "\"" + std::string{ name } + "\": ";
+            auto first = line.find(key);
+
+            if (first == std::string::npos)
+            {
+                throw_invalid("Baseline '", filename, "' is missing '", name, "'");
+            }
+
+            first += key.size();
+            auto const last = line.find_first_of(",}", first);
+            return std::string_view{ line }.substr(first, last - first);
+        };
+
+        while (std::getline(file, line))
+        {
+            if (line.find("\"name\"") == std::string::npos)
+            {
+                continue;
+            }
+
+            auto name = field("name");
+            name.remove_prefix(1);
+            name.remove_suffix(1);
+
+            result baseline{ std::string{ name } };
+            baseline.ns_per_op = std::stod(std::string{ field("ns_per_op") });
+            baseline.allocs_per_op = std::stod(std::string{ field("allocs_per_op") });
+            results.emplace(baseline.name, baseline);
+        }
+
+        return results;
+    }
+
+    static int run(int const argc, char** argv)
+    {
+        writer w;
+        int result{};
+
+        try
+        {
+            auto const args = parse_options(argc, argv);
+            runner r{ args.filter };
+            run_benchmarks(r, args.files);
+
+            std::map<std::string, benchmark::result> baseline;
+
+            if (!args.baseline.empty())
+            {
+                baseline = load_results(args.baseline);
+            }
+
+            auto const limit = 1 + args.tolerance / 100;
+
+            for (auto&& current : r.results())
+            {
+                w.write_printf("%-28s %12.1f ns/op %10.2f allocs/op", current.name.c_str(), current.ns_per_op, current.allocs_per_op);
+                auto previous = baseline.find(current.name);
+
+                if (previous != baseline.end())
+                {
+                    auto const& expected = previous->second;
+                    bool const slower = current.ns_per_op > expected.ns_per_op * limit;
+                    bool const allocates = current.allocs_per_op > expected.allocs_per_op * limit + 0.005;
+                    w.write_printf("  %+7.1f%%", (current.ns_per_op / expected.ns_per_op - 1) * 100);
+
+                    if (slower || allocates)
+                    {
+                        w.write("  REGRESSION");
+                        result = 1;
+                    }
+                }
+
+                w.write('\n');
+            }
+
+            if (!args.save.empty())
+            {
+                save_results(args.save, r.results());
+            }
+        }
+        catch (std::exception const& e)
+        {
+            w.write("benchmark : error %\n", e.what());
+            result = 1;
+        }
+
+        w.flush_to_console(result == 0);
+        return result;
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    return cppwin32::benchmark::run(argc, argv);
+}
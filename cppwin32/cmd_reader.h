@@ -11,10 +11,12 @@
 #include <set>
 #include <filesystem>
 #include <fstream>
+#include <optional>
 #include <regex>
 #include <Windows.h>
 #include <shlwapi.h>
 #include <XmlLite.h>
+#include "task_group.h"
 
 namespace cppwin32
 {
@@ -391,23 +393,29 @@ namespace cppwin32
             return result->second.front();
         }
 
+        // Collects the files named by an option, recursing into directories. Each file is mapped
+        // once on a worker thread, checked with the filter and hashed, and files whose contents
+        // duplicate an earlier path are dropped. Only the files that pass the filter are read in
+        // full. Files in directories that fail the filter are skipped, while a file named directly
+        // must pass it.
         template <typename F>
-        auto files(std::string_view const& name, F directory_filter) const
+        auto files(std::string_view const& name, F filter) const
         {
-            std::set<std::string> files;
+            struct candidate
+            {
+                std::string path;
+                bool named{};
+            };
+
+            std::vector<candidate> candidates;
 
             auto add_directory = [&](auto&& path)
             {
-                for (auto&& file : std::filesystem::directory_iterator(path))
+                for (auto&& file : std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied))
                 {
-                    if (std::filesystem::is_regular_file(file))
+                    if (file.is_regular_file())
                     {
-                        auto filename = file.path().string();
-
-                        if (directory_filter(filename))
-                        {
-                            files.insert(filename);
-                        }
+                        candidates.push_back({ file.path().string(), false });
                     }
                 }
             };
@@ -422,7 +430,7 @@ namespace cppwin32
 
                 if (std::filesystem::is_regular_file(path))
                 {
-                    files.insert(std::filesystem::canonical(path).string());
+                    candidates.push_back({ std::filesystem::canonical(path).string(), true });
                     continue;
                 }
                 if (path == "local")
@@ -457,6 +465,75 @@ namespace cppwin32
                 throw_invalid("Path '", path, "' is not a file or directory");
             }
 
+            // Sort by path, with a file that was named directly ahead of the same file found in a directory.
+            std::sort(candidates.begin(), candidates.end(), [](candidate const& left, candidate const& right)
+                {
+                    return left.path < right.path || (left.path == right.path && left.named > right.named);
+                });
+
+            candidates.erase(std::unique(candidates.begin(), candidates.end(), [](candidate const& left, candidate const& right)
+                {
+                    return left.path == right.path;
+                }), candidates.end());
+
+            std::vector<std::optional<input_file>> mapped(candidates.size());
+
+            {
+                task_group group{ settings.jobs };
+
+                for (size_t i{}; i != candidates.size(); ++i)
+                {
+                    group.add([&, i]
+                        {
+                            auto const& path = candidates[i].path;
+                            winmd::reader::file_view view{ path };
+
+                            if (!filter(view))
+                            {
+                                if (candidates[i].named)
+                                {
+                                    throw_invalid("File '", path, "' is not a metadata file");
+                                }
+
+                                return;
+                            }
+
+                            view.advise(winmd::reader::file_view::access::sequential);
+                            auto const hash = winmd::impl::hash_bytes(view.begin(), view.size());
+                            view.advise(winmd::reader::file_view::access::normal);
+                            mapped[i].emplace(input_file{ std::move(view), hash });
+                        });
+                }
+
+                group.get();
+            }
+
+            std::map<std::string, input_file> files;
+            std::multimap<uint64_t, input_file const*> hashes;
+
+            for (size_t i{}; i != candidates.size(); ++i)
+            {
+                if (!mapped[i])
+                {
+                    continue;
+                }
+
+                auto const& view = mapped[i]->view;
+                auto [first, last] = hashes.equal_range(mapped[i]->hash);
+
+                auto duplicate = std::any_of(first, last, [&](auto&& other)
+                    {
+                        auto const& other_view = other.second->view;
+                        return other_view.size() == view.size() && std::equal(view.begin(), view.end(), other_view.begin());
+                    });
+
+                if (!duplicate)
+                {
+                    auto& file = files.try_emplace(candidates[i].path, std::move(*mapped[i])).first->second;
+                    hashes.emplace(file.hash, &file);
+                }
+            }
+
             return files;
         }
 
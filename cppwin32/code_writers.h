@@ -58,7 +58,7 @@ namespace cppwin32
     static void write_version_assert(writer& w)
     {
         w.write_root_include("base");
-        auto format = R"(static_assert(win32::check_version(CPPWIN32_VERSION, "%"), "Mismatched C++/Win32 headers.");
+        constexpr auto format = R"(static_assert(win32::check_version(CPPWIN32_VERSION, "%"), "Mismatched C++/Win32 headers.");
 #define CPPWIN32_VERSION "%"
 )";
         w.write(format, CPPWIN32_VERSION_STRING, CPPWIN32_VERSION_STRING);
@@ -66,7 +66,7 @@ namespace cppwin32
 
     void write_include_guard(writer& w)
     {
-        auto format = R"(#pragma once
+        constexpr auto format = R"(#pragma once
 )";
 
         w.write(format);
@@ -74,7 +74,7 @@ namespace cppwin32
 
     static void write_endif(writer& w)
     {
-        auto format = R"(#endif
+        constexpr auto format = R"(#endif
 )";
 
         w.write(format);
@@ -101,7 +101,7 @@ namespace cppwin32
             mangled_name += impl;
         }
 
-        auto format = R"(#ifndef WIN32_%_H
+        constexpr auto format = R"(#ifndef WIN32_%_H
 #define WIN32_%_H
 )";
 
@@ -117,7 +117,7 @@ namespace cppwin32
 
     void write_close_namespace(writer& w)
     {
-        auto format = R"(}
+        constexpr auto format = R"(}
 )";
 
         w.write(format);
@@ -125,7 +125,7 @@ namespace cppwin32
 
     [[nodiscard]] static finish_with wrap_impl_namespace(writer& w)
     {
-        auto format = R"(namespace win32::_impl_
+        constexpr auto format = R"(namespace win32::_impl_
 {
 )";
 
@@ -137,7 +137,7 @@ namespace cppwin32
     [[nodiscard]] finish_with wrap_type_namespace(writer& w, std::string_view const& ns)
     {
         // TODO: Move into forwards
-        auto format = R"(WIN32_EXPORT namespace win32::@
+        constexpr auto format = R"(WIN32_EXPORT namespace win32::@
 {
 )";
 
@@ -148,7 +148,7 @@ namespace cppwin32
 
     void write_enum_field(writer& w, Field const& field)
     {
-        auto format = R"(        % = %,
+        constexpr auto format = R"(        % = %,
 )";
 
         if (auto constant = field.Constant())
@@ -159,13 +159,14 @@ namespace cppwin32
 
     void write_enum(writer& w, TypeDef const& type)
     {
-        auto format = R"(    enum class % : %
+        constexpr auto format = R"(    enum class % : %
     {
 %    };
 )";
 
         auto fields = type.FieldList();
         w.write(format, type.TypeName(), fields.first.Signature().Type(), bind_each<write_enum_field>(fields));
+        w.add_declaration(declaration_kind::enum_type);
     }
 
     void write_delegate(writer& w, TypeDef const& type);
@@ -173,9 +174,10 @@ namespace cppwin32
     // Workaround for https://github.com/microsoft/cppwin32/issues/2
     void write_extern_forward(writer& w, TypeRef const& type)
     {
-        auto const format = R"(    struct %;
+        constexpr auto format = R"(    struct %;
 )";
         w.write(format, type.TypeName());
+        w.add_declaration(declaration_kind::forward);
     }
 
     void write_forward(writer& w, TypeDef const& type)
@@ -183,9 +185,10 @@ namespace cppwin32
         if (get_category(type) == category::enum_type)
         {
             type_name type_name(type);
-            auto format = R"(    enum class % : %;
+            constexpr auto format = R"(    enum class % : %;
 )";
             w.write(format, type_name.name, type.FieldList().first.Signature().Type());
+            w.add_declaration(declaration_kind::forward);
             return;
         }
         else if (get_category(type) == category::delegate_type)
@@ -195,16 +198,17 @@ namespace cppwin32
         }
 
         std::string_view const type_keyword = is_union(type) ? "union" : "struct";
-        auto format = R"(    % %;
+        constexpr auto format = R"(    % %;
 )";
 
         w.write(format, type_keyword, type.TypeName());
+        w.add_declaration(declaration_kind::forward);
     }
 
     struct struct_field
     {
         std::string_view name;
-        std::string type;
+        std::string_view type;
         std::optional<int32_t> array_count;
     };
 
@@ -264,6 +268,7 @@ namespace cppwin32
         w.write(R"(    %% %
     %{
 )", bind<write_nesting>(nest_level), type_keyword, type.TypeName(), bind<write_nesting>(nest_level));
+        w.add_declaration(declaration_kind::struct_type);
 
         // Write nested types
         for (auto&& nested_type : type.get_cache().nested_types(type))
@@ -337,6 +342,7 @@ namespace cppwin32
                     constant.Type(),
                     field.Name(),
                     constant);
+                w.add_declaration(declaration_kind::constant);
             }
         }
 
@@ -575,7 +581,23 @@ namespace cppwin32
         w.write("\n        return %;", signature.return_param_name());
     }
 
-    void write_class_abi(writer& w, TypeDef const& type)
+    // The public methods of a class, less those that -roots doesn't need.
+    std::vector<MethodDef> get_projected_methods(TypeDef const& type)
+    {
+        auto methods = get_public_methods(type);
+
+        if (!settings.roots.empty())
+        {
+            std::erase_if(methods, [](MethodDef const& method)
+                {
+                    return !settings.root_functions.contains(method);
+                });
+        }
+
+        return methods;
+    }
+
+    void write_class_methods_abi(writer& w, std::vector<MethodDef> const& methods)
     {
         auto abi_guard = w.push_abi_types(true);
         auto ns_guard = w.push_full_namespace(true);
@@ -583,30 +605,30 @@ namespace cppwin32
         w.write(R"(extern "C"
 {
 )");
-        auto const format = R"xyz(    % __stdcall WIN32_IMPL_%(%) noexcept;
+        constexpr auto format = R"xyz(    % __stdcall WIN32_IMPL_%(%) noexcept;
 )xyz";
 
-        for (auto&& method : type.MethodList())
+        for (auto&& method : methods)
         {
-            if (method.Flags().Access() == MemberAccess::Public)
-            {
-                method_signature signature{ method };
-                w.write(format, bind<write_abi_return>(signature.return_signature()), method.Name(), bind<write_abi_params>(signature));
-            }
+            method_signature signature{ method };
+            w.write(format, bind<write_abi_return>(signature.return_signature()), method.Name(), bind<write_abi_params>(signature));
+            w.add_declaration(declaration_kind::abi_function);
         }
         w.write(R"(}
 )");
 
-        for (auto&& method : type.MethodList())
+        for (auto&& method : methods)
         {
-            if (method.Flags().Access() == MemberAccess::Public)
-            {
-                method_signature signature{ method };
-                w.write("WIN32_IMPL_LINK(%)\n", bind<write_abi_link>(signature));
-            }
+            method_signature signature{ method };
+            w.write("WIN32_IMPL_LINK(%)\n", bind<write_abi_link>(signature));
         }
         w.write("\n");
     }
+
+    void write_class_abi(writer& w, TypeDef const& type)
+    {
+        write_class_methods_abi(w, get_projected_methods(type));
+    }
     
     void write_method_params(writer& w, method_signature const& method_signature)
     {
@@ -643,7 +665,7 @@ namespace cppwin32
 
     void write_class_method(writer& w, method_signature const& method_signature)
     {
-        auto const format = R"xyz(    inline % %(%)
+        constexpr auto format = R"xyz(    inline % %(%)
     {
         %WIN32_IMPL_%(%);%
     }
@@ -657,53 +679,59 @@ namespace cppwin32
             bind<write_method_args>(method_signature),
             bind<write_consume_return_statement>(method_signature)
         );
+        w.add_declaration(declaration_kind::function);
     }
 
-    void write_class(writer& w, TypeDef const& type)
+    void write_class_methods(writer& w, std::vector<MethodDef> const& methods)
     {
-        for (auto&& method : type.MethodList())
+        for (auto&& method : methods)
         {
-            if (method.Flags().Access() == MemberAccess::Public)
-            {
-                method_signature signature{ method };
-                write_class_method(w, signature);
-            }
+            method_signature signature{ method };
+            write_class_method(w, signature);
         }
+    }
 
-        w.write("\n");
-
+    void write_class_constants(writer& w, TypeDef const& type)
+    {
         for (auto&& field : type.FieldList())
         {
-            if (field.Flags().Literal())
+            if (field.Flags().Literal() && (settings.roots.empty() || settings.root_constants.contains(field)))
             {
                 auto const constant = field.Constant();
                 w.write("    inline constexpr % % = %;\n",
                     constant.Type(),
                     field.Name(),
                     constant);
+                w.add_declaration(declaration_kind::constant);
             }
         }
     }
 
+    void write_class(writer& w, TypeDef const& type)
+    {
+        write_class_methods(w, get_projected_methods(type));
+        w.write("\n");
+        write_class_constants(w, type);
+    }
+
     void write_delegate_params(writer& w, method_signature const& method_signature)
     {
         separator s{ w };
         for (auto&& [param, param_signature] : method_signature.params())
         {
             s();
-            std::string type;
-            type = w.write_temp("%", param_signature->Type());
-            w.write("%", type);
+            w.write("%", w.write_temp("%", param_signature->Type()));
         }
     }
 
     void write_delegate(writer& w, TypeDef const& type)
     {
-        auto const format = R"xyz(    using % = % __stdcall(%);
+        constexpr auto format = R"xyz(    using % = % __stdcall(%);
 )xyz";
         method_signature method_signature{ get_delegate_method(type) };
 
         w.write(format, type.TypeName(), bind<write_method_return>(method_signature), bind<write_delegate_params>(method_signature));
+        w.add_declaration(declaration_kind::delegate);
     }
 
     void write_delegates(writer& w, std::vector<TypeDef> const& delegates)
@@ -721,48 +749,40 @@ namespace cppwin32
             });
     }
 
+    bool is_flags_enum(TypeDef const& type)
+    {
+        static attribute_id const flags_attribute = intern_attribute("System", "FlagsAttribute");
+        return static_cast<bool>(find_attribute(type, flags_attribute));
+    }
+
+    // The operators themselves are templates in base.h, enabled by this specialization.
     void write_enum_operators(writer& w, TypeDef const& type)
     {
-        if (!get_attribute(type, "System", "FlagsAttribute"))
+        if (!is_flags_enum(type))
         {
             return;
         }
 
-        auto name = type.TypeName();
-
-        auto format = R"(    constexpr auto operator|(% const left, % const right) noexcept
-    {
-        return static_cast<%>(_impl_::to_underlying_type(left) | _impl_::to_underlying_type(right));
-    }
-    constexpr auto operator|=(%& left, % const right) noexcept
-    {
-        left = left | right;
-        return left;
-    }
-    constexpr auto operator&(% const left, % const right) noexcept
-    {
-        return static_cast<%>(_impl_::to_underlying_type(left) & _impl_::to_underlying_type(right));
-    }
-    constexpr auto operator&=(%& left, % const right) noexcept
-    {
-        left = left & right;
-        return left;
-    }
-    constexpr auto operator~(% const value) noexcept
-    {
-        return static_cast<%>(~_impl_::to_underlying_type(value));
-    }
-    constexpr auto operator^^(% const left, % const right) noexcept
-    {
-        return static_cast<%>(_impl_::to_underlying_type(left) ^^ _impl_::to_underlying_type(right));
+        constexpr auto format = R"(    template <> inline constexpr bool is_flags_v<%> = true;
+)";
+        w.write(format, type);
     }
-    constexpr auto operator^^=(%& left, % const right) noexcept
+
+    void write_flags_operators(writer& w, std::vector<TypeDef> const& enums)
     {
-        left = left ^^ right;
-        return left;
-    }
-)";
-        w.write(format, name, name, name, name, name, name, name, name, name, name, name, name, name, name, name, name, name);
+        if (std::none_of(enums.begin(), enums.end(), is_flags_enum))
+        {
+            return;
+        }
+
+        w.write(R"(    using win32::operator|;
+    using win32::operator|=;
+    using win32::operator&;
+    using win32::operator&=;
+    using win32::operator~;
+    using win32::operator^;
+    using win32::operator^=;
+)");
     }
 
     struct guid
@@ -818,7 +838,7 @@ namespace cppwin32
         {
             return;
         }
-        auto attribute = get_attribute(type, "System.Runtime.InteropServices", "GuidAttribute");
+        auto attribute = get_guid_attribute(type);
         if (!attribute)
         {
             return;
@@ -828,13 +848,14 @@ namespace cppwin32
         auto const guid_str = std::get<std::string_view>(std::get<ElemSig>(sig.FixedArgs()[0].value).value);
         auto const guid_value = to_guid(guid_str);
 
-        auto format = R"(    template <> inline constexpr guid guid_v<%>{ % }; // %
+        constexpr auto format = R"(    template <> inline constexpr guid guid_v<%>{ % }; // %
 )";
 
         w.write(format,
             type,
             bind<write_guid_value>(guid_value),
             guid_str);
+        w.add_declaration(declaration_kind::guid);
     }
 
     void write_base_interface(writer& w, TypeDef const& type)
@@ -849,13 +870,14 @@ namespace cppwin32
     void write_interface(writer& w, TypeDef const& type)
     {
         {
-            auto const format = R"(    struct __declspec(novtable) %%
+            constexpr auto format = R"(    struct __declspec(novtable) %%
     {
 )";
             w.write(format, type.TypeName(), bind<write_base_interface>(type));
+            w.add_declaration(declaration_kind::interface_type);
         }
 
-        auto const format = R"(        virtual % __stdcall %(%) noexcept = 0;
+        constexpr auto format = R"(        virtual % __stdcall %(%) noexcept = 0;
 )";
         auto abi_guard = w.push_abi_types(true);
 
@@ -916,7 +938,7 @@ namespace cppwin32
         auto const& method_list = type.MethodList();
         auto const impl_name = get_impl_name(type.TypeNamespace(), type.TypeName());
 
-        auto const format = R"(    struct consume_%
+        constexpr auto format = R"(    struct consume_%
     {
 %    };
 )";
@@ -928,7 +950,8 @@ namespace cppwin32
 
     void write_raii_helper(writer& w, Param const& param, std::set<std::string_view>& helpers)
     {
-        auto const attr = get_attribute(param, "Windows.Win32.Interop", "RAIIFreeAttribute");
+        static attribute_id const raii_free_attribute = intern_attribute("Windows.Win32.Interop", "RAIIFreeAttribute");
+        auto const attr = find_attribute(param, raii_free_attribute);
         if (!attr)
         {
             return;
@@ -980,7 +1003,7 @@ namespace cppwin32
         auto const method_name = method.Name();
         auto signature = method_signature(method);
 
-        auto const format = R"(    WIN32_IMPL_AUTO(%) consume_%::%(%) const
+        constexpr auto format = R"(    WIN32_IMPL_AUTO(%) consume_%::%(%) const
     {
         %WIN32_IMPL_SHIM(%)->%(%);%
     }
@@ -2,16 +2,140 @@
 
 namespace cppwin32
 {
-    static void write_namespace_0_h(std::string_view const& ns, cache::namespace_members const& members)
+    // Struct and interface definitions are written to win32/impl/<unit>.structs.h and
+    // win32/impl/<unit>.interfaces.h, one header per definition_units unit, in dependency order.
+    // A unit's header includes the headers of only those units that its types depend on.
+    static definition_units get_struct_units(std::map<std::string_view, cache::namespace_members> const& namespaces)
+    {
+        type_dependency_graph graph;
+        for (auto&& [ns, members] : namespaces)
+        {
+            for (auto&& s : members.structs)
+            {
+                graph.add_struct(s);
+            }
+        }
+
+        return definition_units{ graph };
+    }
+
+    static definition_units get_interface_units(std::map<std::string_view, cache::namespace_members> const& namespaces)
+    {
+        type_dependency_graph graph;
+        for (auto&& [ns, members] : namespaces)
+        {
+            for (auto&& s : members.interfaces)
+            {
+                graph.add_interface(s);
+            }
+        }
+
+        return definition_units{ graph };
+    }
+
+    static void write_struct_definition(writer& w, TypeDef const& type)
+    {
+        auto guard = wrap_type_namespace(w, type.TypeNamespace());
+        write_struct(w, type);
+    }
+
+    static void write_interface_definition(writer& w, TypeDef const& type)
+    {
+        auto guard = wrap_type_namespace(w, type.TypeNamespace());
+        write_interface(w, type);
+    }
+
+    inline void write_structs_h(std::string_view const& name, definition_units::unit const& unit)
+    {
+        writer w;
+        auto prologue = w.add_insertion_point();
+
+        for (auto&& type : unit.types)
+        {
+            write_struct_definition(w, type);
+        }
+
+        write_close_file_guard(w);
+        {
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, w.write_temp("%.structs", name));
+
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '0');
+            }
+
+            for (auto&& depends : unit.depends)
+            {
+                w.write_root_include(w.write_temp("impl/%.structs", depends));
+            }
+        }
+
+        w.save_file(settings.output_folder + "win32/impl/" + std::string{ name } + ".structs.h");
+    }
+
+    inline void write_interfaces_h(std::string_view const& name, definition_units::unit const& unit)
     {
         writer w;
+        auto prologue = w.add_insertion_point();
+
+        for (auto&& type : unit.types)
+        {
+            write_interface_definition(w, type);
+        }
+
+        write_close_file_guard(w);
+        {
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, w.write_temp("%.interfaces", name));
+
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '1');
+            }
+
+            for (auto&& depends : unit.depends)
+            {
+                w.write_root_include(w.write_temp("impl/%.interfaces", depends));
+            }
+            // Workaround for https://github.com/microsoft/cppwin32/issues/2
+            for (auto&& extern_depends : w.extern_depends)
+            {
+                auto guard = wrap_type_namespace(w, extern_depends.first);
+                w.write_each<write_extern_forward>(extern_depends.second);
+            }
+        }
+
+        w.save_file(settings.output_folder + "win32/impl/" + std::string{ name } + ".interfaces.h");
+    }
+
+    // Includes the definitions header of the unit that holds a namespace's types, if it has any.
+    static void write_definitions_include(writer& w, definition_units const& units, std::string_view const& ns, std::string_view const& kind)
+    {
+        if (auto const name = units.names.find(ns); name != units.names.end())
+        {
+            w.write_root_include(w.write_temp("impl/%.%", name->second, kind));
+        }
+    }
+
+    static void write_namespace_0_h(writer& w, std::string_view const& ns, cache::namespace_members const& members)
+    {
         w.type_namespace = ns;
+        auto prologue = w.add_insertion_point();
 
         {
             auto wrap = wrap_type_namespace(w, ns);
 
             w.write("#pragma region enums\n");
             w.write_each<write_enum>(members.enums);
+
+            if (settings.flags)
+            {
+                write_flags_operators(w, members.enums);
+            }
+
             w.write("#pragma endregion enums\n\n");
 
             w.write("#pragma region forward_declarations\n");
@@ -29,29 +153,42 @@ namespace cppwin32
             w.write("#pragma region guids\n");
             w.write_each<write_guid>(members.interfaces);
             w.write("#pragma endregion guids\n\n");
+
+            if (settings.flags)
+            {
+                w.write("#pragma region flags\n");
+                w.write_each<write_enum_operators>(members.enums);
+                w.write("#pragma endregion flags\n\n");
+            }
         }
 
         write_close_file_guard(w);
-        w.swap();
-
-        write_preamble(w);
-        write_open_file_guard(w, ns, '0');
-
-        for (auto&& depends : w.depends)
         {
-            auto guard = wrap_type_namespace(w, depends.first);
-            w.write_each<write_forward>(depends.second);
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, ns, '0');
+
+            for (auto&& depends : w.depends)
+            {
+                auto guard = wrap_type_namespace(w, depends.first);
+                w.write_each<write_forward>(depends.second);
+            }
         }
+    }
 
+    inline void write_namespace_0_h(std::string_view const& ns, cache::namespace_members const& members)
+    {
+        writer w;
+        write_namespace_0_h(w, ns, members);
         w.save_header('0');
     }
 
-    static void write_namespace_1_h(std::string_view const& ns, cache::namespace_members const& members)
+    static void write_namespace_1_h(writer& w, std::string_view const& ns, cache::namespace_members const& members, definition_units const& structs)
     {
-        writer w;
         w.type_namespace = ns;
-        
-        w.write("#include \"win32/impl/complex_structs.h\"\n");
+        auto prologue = w.add_insertion_point();
+
+        write_definitions_include(w, structs, ns, "structs");
 
         {
             auto wrap = wrap_type_namespace(w, ns);
@@ -62,26 +199,35 @@ namespace cppwin32
         }
 
         write_close_file_guard(w);
-        w.swap();
-        write_preamble(w);
-        write_open_file_guard(w, ns, '1');
-
-        for (auto&& depends : w.depends)
         {
-            w.write_depends(depends.first, '0');
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, ns, '1');
+
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '0');
+            }
+
+            w.write_depends(w.type_namespace, '0');
         }
+    }
 
-        w.write_depends(w.type_namespace, '0');
+    inline void write_namespace_1_h(std::string_view const& ns, cache::namespace_members const& members, definition_units const& structs)
+    {
+        writer w;
+        write_namespace_1_h(w, ns, members, structs);
         w.save_header('1');
     }
 
-    static void write_namespace_2_h(std::string_view const& ns, cache::namespace_members const& members)
+    static void write_namespace_2_h(writer& w, std::string_view const& ns, cache::namespace_members const& members, definition_units const& interfaces)
     {
-        writer w;
         w.type_namespace = ns;
+        auto prologue = w.add_insertion_point();
 
-        w.write("#include \"win32/impl/complex_interfaces.h\"\n");
+        write_definitions_include(w, interfaces, ns, "interfaces");
 
+        if (settings.split == api_split::none)
         {
             // No namespace
             w.write("#pragma region abi_methods\n");
@@ -90,123 +236,252 @@ namespace cppwin32
         }
 
         write_close_file_guard(w);
-        w.swap();
-        write_preamble(w);
-        write_open_file_guard(w, ns, '2');
-
-        w.write_depends(w.type_namespace, '1');
-        // Workaround for https://github.com/microsoft/cppwin32/issues/2
-        for (auto&& extern_depends : w.extern_depends)
         {
-            auto guard = wrap_type_namespace(w, extern_depends.first);
-            w.write_each<write_extern_forward>(extern_depends.second);
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, ns, '2');
+
+            w.write_depends(w.type_namespace, '1');
+
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '0');
+            }
+
+            // Workaround for https://github.com/microsoft/cppwin32/issues/2
+            for (auto&& extern_depends : w.extern_depends)
+            {
+                auto guard = wrap_type_namespace(w, extern_depends.first);
+                w.write_each<write_extern_forward>(extern_depends.second);
+            }
         }
+    }
+
+    inline void write_namespace_2_h(std::string_view const& ns, cache::namespace_members const& members, definition_units const& interfaces)
+    {
+        writer w;
+        write_namespace_2_h(w, ns, members, interfaces);
         w.save_header('2');
     }
 
-    static void write_namespace_h(std::string_view const& ns, cache::namespace_members const& members)
+    // The DLL that a function is imported from, without its extension, or the leading word or
+    // acronym of its name, as in Reg, WSA or D3D12. Group names are used as both file names and
+    // include guards, so they are lowercased and reduced to letters, digits and underscores.
+    static std::string get_function_group(MethodDef const& method)
+    {
+        std::string group;
+
+        if (settings.split == api_split::module)
+        {
+            if (auto const import = method.ImplMap())
+            {
+                auto name = import.ImportScope().Name();
+                constexpr std::string_view extension{ ".dll" };
+
+                // The group is lowercased below, so only the extension is compared without case here.
+                if (name.size() >= extension.size() && std::equal(extension.begin(), extension.end(), name.end() - extension.size(), [](char const left, char const right)
+                    {
+                        return left == std::tolower(static_cast<unsigned char>(right));
+                    }))
+                {
+                    name.remove_suffix(extension.size());
+                }
+
+                group = name;
+            }
+        }
+        else
+        {
+            auto const name = method.Name();
+            auto is_upper = [](char const c) { return std::isupper(static_cast<unsigned char>(c)) || std::isdigit(static_cast<unsigned char>(c)); };
+            size_t length = 1;
+
+            if (name.size() > 1 && is_upper(name[0]) && is_upper(name[1]))
+            {
+                while (length < name.size() && is_upper(name[length]))
+                {
+                    ++length;
+                }
+
+                // The last capital starts the next word, as in D3D12CreateDevice.
+                if (length > 2 && length < name.size() && std::islower(static_cast<unsigned char>(name[length])))
+                {
+                    --length;
+                }
+            }
+            else
+            {
+                while (length < name.size() && !is_upper(name[length]) && name[length] != '_')
+                {
+                    ++length;
+                }
+            }
+
+            group = name.substr(0, length);
+        }
+
+        if (group.empty())
+        {
+            group = "other";
+        }
+
+        for (auto&& c : group)
+        {
+            c = std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : '_';
+        }
+
+        // Keeps the name free for the namespace's constants header.
+        if (group == "constants")
+        {
+            group += '_';
+        }
+
+        return group;
+    }
+
+    static void write_function_group_h(std::string_view const& ns, std::string const& group, std::vector<MethodDef> const& methods)
     {
         writer w;
         w.type_namespace = ns;
+        auto prologue = w.add_insertion_point();
+
+        {
+            // No namespace
+            w.write("#pragma region abi_methods\n");
+            write_class_methods_abi(w, methods);
+            w.write("#pragma endregion abi_methods\n\n");
+        }
         {
             auto wrap = wrap_type_namespace(w, ns);
 
             w.write("#pragma region methods\n");
-            w.write_each<write_class>(members.classes);
+            write_class_methods(w, methods);
             w.write("#pragma endregion methods\n\n");
         }
 
         write_close_file_guard(w);
-        w.swap();
-        write_preamble(w);
-        write_open_file_guard(w, ns);
-        write_version_assert(w);
-
-        w.write_depends(w.type_namespace, '2');
-        // Workaround for https://github.com/microsoft/cppwin32/issues/2
-        for (auto&& extern_depends : w.extern_depends)
         {
-            auto guard = wrap_type_namespace(w, extern_depends.first);
-            w.write_each<write_extern_forward>(extern_depends.second);
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, w.write_temp("%.%", ns, group));
+            write_version_assert(w);
+
+            w.write_depends(w.type_namespace, '2');
+
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '1');
+            }
+
+            // Workaround for https://github.com/microsoft/cppwin32/issues/2
+            for (auto&& extern_depends : w.extern_depends)
+            {
+                auto guard = wrap_type_namespace(w, extern_depends.first);
+                w.write_each<write_extern_forward>(extern_depends.second);
+            }
         }
-        w.save_header();
+
+        w.save_file(settings.output_folder + "win32/" + std::string{ ns } + "/" + group + ".h");
     }
 
-    static void write_complex_structs_h(cache const& c)
+    static void write_constants_h(std::string_view const& ns, cache::namespace_members const& members)
     {
         writer w;
+        w.type_namespace = ns;
+        auto prologue = w.add_insertion_point();
 
-        type_dependency_graph graph;
-        for (auto&& [ns, members] : c.namespaces())
         {
-            for (auto&& s : members.structs)
-            {
-                graph.add_struct(s);
-            }
-        }
+            auto wrap = wrap_type_namespace(w, ns);
 
-        graph.walk_graph([&](TypeDef const& type)
-            {
-                if (!is_nested(type))
-                {
-                    auto guard = wrap_type_namespace(w, type.TypeNamespace());
-                    write_struct(w, type);
-                }
-            });
+            w.write("#pragma region constants\n");
+            w.write_each<write_class_constants>(members.classes);
+            w.write("#pragma endregion constants\n\n");
+        }
 
         write_close_file_guard(w);
-        w.swap();
-
-        write_preamble(w);
-        write_open_file_guard(w, "complex_structs");
-
-        for (auto&& depends : w.depends)
         {
-            w.write_depends(depends.first, '0');
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, w.write_temp("%.constants", ns));
+            write_version_assert(w);
         }
 
-        w.flush_to_file(settings.output_folder + "win32/impl/complex_structs.h");
+        w.save_file(settings.output_folder + "win32/" + std::string{ ns } + "/constants.h");
     }
 
-    static void write_complex_interfaces_h(cache const& c)
+    // With -split, a namespace's functions are written to win32/<ns>/<group>.h and its constants
+    // to win32/<ns>/constants.h, so that a translation unit can include only the functions it
+    // calls. The namespace header still includes all of them.
+    static void write_split_headers(writer& w, std::string_view const& ns, cache::namespace_members const& members)
     {
-        writer w;
+        std::map<std::string, std::vector<MethodDef>> groups;
 
-        type_dependency_graph graph;
-        for (auto&& [ns, members] : c.namespaces())
+        for (auto&& type : members.classes)
         {
-            for (auto&& s : members.interfaces)
+            for (auto&& method : get_projected_methods(type))
             {
-                graph.add_interface(s);
+                groups[get_function_group(method)].push_back(method);
             }
         }
 
-        graph.walk_graph([&](TypeDef const& type)
-            {
-                if (!is_nested(type))
-                {
-                    auto guard = wrap_type_namespace(w, type.TypeNamespace());
-                    write_interface(w, type);
-                }
-            });
+        std::filesystem::create_directories(settings.output_folder + "win32/" + std::string{ ns });
 
-        write_close_file_guard(w);
-        w.swap();
+        for (auto&& [group, methods] : groups)
+        {
+            write_function_group_h(ns, group, methods);
+            w.write_root_include(w.write_temp("%/%", ns, group));
+        }
 
-        write_preamble(w);
-        write_open_file_guard(w, "complex_interfaces");
+        write_constants_h(ns, members);
+        w.write_root_include(w.write_temp("%/constants", ns));
+    }
 
-        for (auto&& depends : w.depends)
+    static void write_namespace_h(writer& w, std::string_view const& ns, cache::namespace_members const& members)
+    {
+        w.type_namespace = ns;
+        auto prologue = w.add_insertion_point();
+
+        if (settings.split == api_split::none)
+        {
+            auto wrap = wrap_type_namespace(w, ns);
+
+            w.write("#pragma region methods\n");
+            w.write_each<write_class>(members.classes);
+            w.write("#pragma endregion methods\n\n");
+        }
+        else
         {
-            w.write_depends(depends.first, '1');
+            write_split_headers(w, ns, members);
         }
-        // Workaround for https://github.com/microsoft/cppwin32/issues/2
-        for (auto&& extern_depends : w.extern_depends)
+
+        write_close_file_guard(w);
         {
-            auto guard = wrap_type_namespace(w, extern_depends.first);
-            w.write_each<write_extern_forward>(extern_depends.second);
+            auto prologue_guard = w.write_at(prologue);
+            write_preamble(w);
+            write_open_file_guard(w, ns);
+            write_version_assert(w);
+
+            w.write_depends(w.type_namespace, '2');
+
+            // Parameters and return values of other namespaces' structs need their definitions.
+            for (auto&& depends : w.depends)
+            {
+                w.write_depends(depends.first, '1');
+            }
+
+            // Workaround for https://github.com/microsoft/cppwin32/issues/2
+            for (auto&& extern_depends : w.extern_depends)
+            {
+                auto guard = wrap_type_namespace(w, extern_depends.first);
+                w.write_each<write_extern_forward>(extern_depends.second);
+            }
         }
+    }
 
-        w.flush_to_file(settings.output_folder + "win32/impl/complex_interfaces.h");
+    inline void write_namespace_h(std::string_view const& ns, cache::namespace_members const& members)
+    {
+        writer w;
+        write_namespace_h(w, ns, members);
+        w.save_header();
     }
-}
\ No newline at end of file
+}
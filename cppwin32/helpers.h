@@ -16,29 +16,61 @@ namespace cppwin32
     {
         std::string_view name;
         std::string_view name_space;
+        string_atom name_atom{};
+        string_atom name_space_atom{};
+        database const* db{};
 
         explicit type_name(TypeDef const& type) :
             name(type.TypeName()),
-            name_space(type.TypeNamespace())
+            name_space(type.TypeNamespace()),
+            name_atom(type.TypeNameAtom()),
+            name_space_atom(type.TypeNamespaceAtom()),
+            db(&type.get_database())
         {
         }
 
         explicit type_name(TypeRef const& type) :
             name(type.TypeName()),
-            name_space(type.TypeNamespace())
+            name_space(type.TypeNamespace()),
+            name_atom(type.TypeNameAtom()),
+            name_space_atom(type.TypeNamespaceAtom()),
+            db(&type.get_database())
         {
         }
 
         explicit type_name(coded_index<TypeDefOrRef> const& type)
         {
-            auto const& [type_namespace, type_name] = get_type_namespace_and_name(type);
-            name_space = type_namespace;
-            name = type_name;
+            if (type.type() == TypeDefOrRef::TypeDef)
+            {
+                *this = type_name{ type.TypeDef() };
+            }
+            else if (type.type() == TypeDefOrRef::TypeRef)
+            {
+                *this = type_name{ type.TypeRef() };
+            }
+            else
+            {
+                auto const& [type_namespace, type_name] = get_type_namespace_and_name(type);
+                name_space = type_namespace;
+                name = type_name;
+            }
         }
     };
 
     bool operator==(type_name const& left, type_name const& right)
     {
+        // Atoms are only comparable within the cache that numbered them.
+        if (left.name_atom && right.name_atom && left.name_space_atom && right.name_space_atom)
+        {
+            auto const same_cache = left.db->shares_atoms(*right.db);
+            XLANG_ASSERT(same_cache);
+
+            if (same_cache)
+            {
+                return left.name_atom == right.name_atom && left.name_space_atom == right.name_space_atom;
+            }
+        }
+
         return left.name == right.name && left.name_space == right.name_space;
     }
 
@@ -62,39 +94,45 @@ namespace cppwin32
         return 0 == right.compare(0, left.name_space.size(), left.name_space);
     }
 
+    // Views the signature that the cache decoded for a method. A method from a database outside
+    // a cache is decoded into the view itself, so views can't be copied.
     struct method_signature
     {
+        method_signature(method_signature const&) = delete;
+        method_signature& operator=(method_signature const&) = delete;
+
         explicit method_signature(MethodDef const& method) :
-            m_method(method),
-            m_signature(method.Signature())
+            m_method(method)
         {
-            auto params = method.ParamList();
-
-            if (m_signature.ReturnType() && params.first != params.second && params.first.Sequence() == 0)
+            if (auto const signatures = method.get_database().get_method_signatures())
             {
-                m_return = params.first;
-                ++params.first;
+                auto const row = method.index();
+                m_return_type = &*signatures->return_types[row];
+                m_params = { signatures->params.data() + signatures->param_offsets[row], signatures->params.data() + signatures->param_offsets[row + 1] };
+                m_return = signatures->return_params[row];
+                return;
             }
 
-            for (uint32_t i{}; i != size(m_signature.Params()); ++i)
-            {
-                m_params.emplace_back(params.first + i, &m_signature.Params().first[i]);
-            }
-        }
+            m_owned_signature.emplace(method.Signature());
+            m_return_type = &m_owned_signature->ReturnType();
+            auto const [first, last] = m_owned_signature->Params();
 
-        std::vector<std::pair<Param, ParamSig const*>>& params()
-        {
-            return m_params;
+            m_return = match_params(method, *m_return_type, { first, last }, [&](Param const& param, ParamSig const* signature)
+                {
+                    m_owned_params.emplace_back(param, signature);
+                });
+
+            m_params = m_owned_params;
         }
 
-        std::vector<std::pair<Param, ParamSig const*>> const& params() const
+        std::span<std::pair<Param, ParamSig const*> const> params() const
         {
             return m_params;
         }
 
         auto const& return_signature() const
         {
-            return m_signature.ReturnType();
+            return *m_return_type;
         }
 
         auto return_param_name() const
@@ -126,9 +164,11 @@ namespace cppwin32
     private:
 
         MethodDef m_method;
-        MethodDefSig m_signature;
-        std::vector<std::pair<Param, ParamSig const*>> m_params;
+        RetTypeSig const* m_return_type{};
+        std::span<std::pair<Param, ParamSig const*> const> m_params;
         Param m_return;
+        std::optional<MethodDefSig> m_owned_signature;
+        std::vector<std::pair<Param, ParamSig const*>> m_owned_params;
     };
 
     enum class param_category
@@ -211,24 +251,21 @@ namespace cppwin32
 
     inline bool is_com_interface(TypeDef const& type)
     {
-        if (type.TypeName() == "IUnknown")
+        if (auto traits = type.get_database().get_type_traits(type.index()))
         {
-            return true;
+            return traits->com_interface;
         }
 
-        for (auto&& base : type.InterfaceImpl())
-        {
-            auto base_type = find(base.Interface());
-            if (base_type && is_com_interface(base_type))
-            {
-                return true;
-            }
-        }
-        return false;
+        return compute_com_interface(type);
     }
 
     inline bool is_union(TypeDef const& type)
     {
+        if (auto traits = type.get_database().get_type_traits(type.index()))
+        {
+            return traits->union_type;
+        }
+
         return type.Flags().Layout() == TypeLayout::ExplicitLayout;
     }
 
@@ -248,9 +285,11 @@ namespace cppwin32
     MethodDef get_delegate_method(TypeDef const& type)
     {
         MethodDef invoke;
+        auto const invoke_atom = type.get_database().find_string_atom("Invoke");
+
         for (auto&& method : type.MethodList())
         {
-            if (method.Name() == "Invoke")
+            if (invoke_atom ? method.NameAtom() == invoke_atom : method.Name() == "Invoke")
             {
                 invoke = method;
                 break;
@@ -259,6 +298,21 @@ namespace cppwin32
         return invoke;
     }
 
+    std::vector<MethodDef> get_public_methods(TypeDef const& type)
+    {
+        std::vector<MethodDef> methods;
+
+        for (auto&& method : type.MethodList())
+        {
+            if (method.Flags().Access() == MemberAccess::Public)
+            {
+                methods.push_back(method);
+            }
+        }
+
+        return methods;
+    }
+
     coded_index<TypeDefOrRef> get_base_interface(TypeDef const& type)
     {
         auto bases = type.InterfaceImpl();
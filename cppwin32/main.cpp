@@ -1,19 +1,26 @@
 #include <winmd_reader.h>
-#include "cmd_reader.h"
 #include "settings.h"
+#include "cmd_reader.h"
+#include "manifest.h"
 #include "task_group.h"
 #include "text_writer.h"
+#include "profiler.h"
+#include "report.h"
 #include "type_dependency_graph.h"
 #include "type_writers.h"
 #include "code_writers.h"
 #include "file_writers.h"
 #include <unordered_set>
+#include "allocation_counter.h"
 
 using namespace std::filesystem;
 
 namespace cppwin32
 {
     settings_type settings;
+    generation_manifest manifest;
+    profiler profile;
+    header_report report;
 
     struct usage_exception {};
 
@@ -23,10 +30,17 @@ namespace cppwin32
         { "reference", 0, option::no_max, "<spec>", "Windows metadata to reference from projection" },
         { "output", 0, 1, "<path>", "Location of generated projection and component templates" },
         { "verbose", 0, 0, {}, "Show detailed progress information" },
+        { "jobs", 0, 1, "<count>", "Maximum number of worker threads (defaults to processor count)" },
         { "pch", 0, 1, "<name>", "Specify name of precompiled header file (defaults to pch.h)" },
         { "include", 0, option::no_max, "<prefix>", "One or more prefixes to include in input" },
         { "exclude", 0, option::no_max, "<prefix>", "One or more prefixes to exclude from input" },
         { "base", 0, 0, {}, "Generate base.h unconditionally" },
+        { "force", 0, 0, {}, "Regenerate even if the output is up to date" },
+        { "profile", 0, 1, "<file>", "Write a Chrome trace of the run's phases and counters" },
+        { "report", 0, 1, "<file>", "Write the size, declarations and include closure of each generated header" },
+        { "roots", 0, option::no_max, "<name>", "Generate only these functions, constants and types, and what they depend on" },
+        { "flags", 0, 0, {}, "Define bitwise operators for enums with the FlagsAttribute" },
+        { "split", 0, 1, "<module|prefix>", "Write each namespace's functions to a header per DLL or name prefix, and its constants to their own header" },
         { "help", 0, option::no_max, {}, "Show detailed help with examples" },
         { "?", 0, option::no_max, {}, {} },
         { "library", 0, 1, "<prefix>", "Specify library prefix (defaults to win32)" },
@@ -52,7 +66,7 @@ namespace cppwin32
             printColumns(w, w.write_temp("-% %", opt.name, opt.arg), opt.desc);
         };
 
-        auto format = R"(
+        constexpr auto format = R"(
 C++/Win32 v%
 Copyright (c) Microsoft Corporation. All rights reserved.
 
@@ -72,16 +86,50 @@ Where <spec> is one or more of:
     static void process_args(reader const& args)
     {
         settings.verbose = args.exists("verbose");
+
+        if (args.exists("jobs"))
+        {
+            auto const jobs = args.value("jobs");
+            auto const [last, error] = std::from_chars(jobs.data(), jobs.data() + jobs.size(), settings.jobs);
+
+            if (error != std::errc{} || last != jobs.data() + jobs.size() || settings.jobs == 0)
+            {
+                throw_invalid("Option '-jobs' requires a positive number");
+            }
+        }
         settings.fastabi = args.exists("fastabi");
 
-        settings.input = args.files("input", database::is_database);
-        settings.reference = args.files("reference", database::is_database);
+        auto const is_database = [](byte_view const& file) { return database::is_database(file); };
+        settings.input = args.files("input", is_database);
+        settings.reference = args.files("reference", is_database);
 
         settings.component = args.exists("component");
         settings.base = args.exists("base");
+        settings.force = args.exists("force");
+        settings.profile = args.value("profile");
+        settings.report = args.value("report");
 
         settings.license = args.exists("license");
         settings.brackets = args.exists("brackets");
+        settings.flags = args.exists("flags");
+
+        if (args.exists("split"))
+        {
+            auto const split = args.value("split");
+
+            if (split == "module")
+            {
+                settings.split = api_split::module;
+            }
+            else if (split == "prefix")
+            {
+                settings.split = api_split::prefix;
+            }
+            else
+            {
+                throw_invalid("Option '-split' requires 'module' or 'prefix'");
+            }
+        }
 
         std::filesystem::path output_folder = args.value("output");
         std::filesystem::create_directories(output_folder / "win32/impl");
@@ -103,6 +151,28 @@ Where <spec> is one or more of:
             settings.exclude.insert(exclude);
         }
 
+        settings.projection_filter = { settings.include, settings.exclude };
+
+        for (auto&& roots : args.values("roots"))
+        {
+            for (size_t first{}; first < roots.size();)
+            {
+                auto last = roots.find(',', first);
+
+                if (last == std::string::npos)
+                {
+                    last = roots.size();
+                }
+
+                if (last != first)
+                {
+                    settings.roots.insert(roots.substr(first, last - first));
+                }
+
+                first = last + 1;
+            }
+        }
+
         if (settings.component)
         {
             settings.component_overwrite = args.exists("overwrite");
@@ -143,14 +213,301 @@ Where <spec> is one or more of:
         }
     }
 
-    static auto get_files_to_cache()
+    // Hands the mappings made while reading the arguments to the cache, so no file is opened twice.
+    static auto take_files_to_cache()
     {
-        std::vector<std::string> files;
-        files.insert(files.end(), settings.input.begin(), settings.input.end());
-        files.insert(files.end(), settings.reference.begin(), settings.reference.end());
+        std::vector<cache::mapped_file> files;
+
+        for (auto&& [path, file] : settings.input)
+        {
+            files.push_back({ path, std::move(file.view) });
+        }
+
+        for (auto&& [path, file] : settings.reference)
+        {
+            files.push_back({ path, std::move(file.view) });
+        }
+
         return files;
     }
 
+    // Looks the roots up by type, function or constant name, or by the type's full name, and
+    // collects what they need into settings.root_functions and settings.root_constants.
+    static std::set<TypeDef> get_root_closure(cache const& c)
+    {
+        struct named
+        {
+            std::vector<TypeDef> types;
+            std::vector<MethodDef> functions;
+            std::vector<Field> constants;
+        };
+
+        std::map<std::string_view, named> names;
+
+        for (auto&& [ns, members] : c.namespaces())
+        {
+            for (auto&& [name, type] : members.types)
+            {
+                names[name].types.push_back(type);
+            }
+
+            for (auto&& type : members.classes)
+            {
+                for (auto&& method : get_public_methods(type))
+                {
+                    names[method.Name()].functions.push_back(method);
+                }
+
+                for (auto&& field : type.FieldList())
+                {
+                    if (field.Flags().Literal())
+                    {
+                        names[field.Name()].constants.push_back(field);
+                    }
+                }
+            }
+        }
+
+        type_closure closure{ c };
+
+        for (auto&& root : settings.roots)
+        {
+            if (root.find('.') != std::string::npos)
+            {
+                closure.add_type(c.find_required(root));
+                continue;
+            }
+
+            auto position = names.find(root);
+
+            if (position == names.end())
+            {
+                throw_invalid("Root '", root, "' could not be found");
+            }
+
+            for (auto&& type : position->second.types)
+            {
+                closure.add_type(type);
+            }
+
+            for (auto&& method : position->second.functions)
+            {
+                closure.add_function(method);
+            }
+
+            for (auto&& field : position->second.constants)
+            {
+                closure.add_constant(field);
+            }
+        }
+
+        closure.complete();
+        settings.root_functions = std::move(closure.functions);
+        settings.root_constants = std::move(closure.constants);
+        return std::move(closure.types);
+    }
+
+    // The namespace members that are generated: those that -include and -exclude select and,
+    // given -roots, that the roots need, plus the types that those refer to. A class is kept if
+    // any of its functions or constants are.
+    static std::map<std::string_view, cache::namespace_members> get_projection(cache const& c)
+    {
+        std::set<TypeDef> root_types;
+        std::set<TypeDef> root_classes;
+
+        if (!settings.roots.empty())
+        {
+            root_types = get_root_closure(c);
+
+            for (auto&& method : settings.root_functions)
+            {
+                root_classes.insert(method.Parent());
+            }
+
+            for (auto&& field : settings.root_constants)
+            {
+                root_classes.insert(field.Parent());
+            }
+        }
+
+        auto selected = [&](TypeDef const& type)
+        {
+            if (!settings.projection_filter.includes(type))
+            {
+                return false;
+            }
+
+            return settings.roots.empty() || root_types.contains(type) || root_classes.contains(type);
+        };
+
+        // -include and -exclude may drop types that the selected ones refer to, so those are
+        // pulled back in, as their namespaces' headers are included all the same.
+        std::set<TypeDef> dependencies;
+
+        if (!settings.projection_filter.empty())
+        {
+            type_closure closure{ c };
+
+            for (auto&& [ns, members] : c.namespaces())
+            {
+                for (auto&& [name, type] : members.types)
+                {
+                    if (!selected(type))
+                    {
+                        continue;
+                    }
+
+                    closure.add_type(type);
+
+                    if (get_category(type) == category::class_type)
+                    {
+                        for (auto&& method : get_projected_methods(type))
+                        {
+                            closure.add_function(method);
+                        }
+                    }
+                }
+            }
+
+            closure.complete();
+            dependencies = std::move(closure.types);
+        }
+
+        auto includes = [&](TypeDef const& type)
+        {
+            return selected(type) || dependencies.contains(type);
+        };
+
+        auto copy = [&](std::vector<TypeDef> const& from, std::vector<TypeDef>& to)
+        {
+            std::copy_if(from.begin(), from.end(), std::back_inserter(to), includes);
+        };
+
+        std::map<std::string_view, cache::namespace_members> result;
+
+        for (auto&& [ns, members] : c.namespaces())
+        {
+            cache::namespace_members projected;
+
+            for (auto&& [name, type] : members.types)
+            {
+                if (includes(type))
+                {
+                    projected.types.emplace(name, type);
+                }
+            }
+
+            if (projected.types.empty())
+            {
+                continue;
+            }
+
+            copy(members.interfaces, projected.interfaces);
+            copy(members.classes, projected.classes);
+            copy(members.enums, projected.enums);
+            copy(members.structs, projected.structs);
+            copy(members.delegates, projected.delegates);
+            copy(members.attributes, projected.attributes);
+            copy(members.contracts, projected.contracts);
+            result.emplace(ns, std::move(projected));
+        }
+
+        return result;
+    }
+
+    static std::string get_manifest_path()
+    {
+        return settings.output_folder + "win32/impl/cppwin32.manifest";
+    }
+
+    // Hashes everything that affects the generated output: the metadata files, the options
+    // and the base.h that is copied into the projection.
+    static uint64_t get_manifest_key()
+    {
+        auto key = generation_manifest::hash_seed;
+        key = generation_manifest::hash(key, CPPWIN32_VERSION_STRING);
+
+        auto hash_list = [&](std::string_view const& name, std::set<std::string> const& values)
+        {
+            key = generation_manifest::hash(key, name);
+
+            for (auto&& value : values)
+            {
+                key = generation_manifest::hash(key, value);
+            }
+        };
+
+        hash_list("include", settings.include);
+        hash_list("exclude", settings.exclude);
+        hash_list("roots", settings.roots);
+        key = generation_manifest::hash(key, settings.license ? "license" : "");
+        key = generation_manifest::hash(key, settings.brackets ? "brackets" : "");
+        key = generation_manifest::hash(key, settings.flags ? "flags" : "");
+        key = generation_manifest::hash(key, &settings.split, sizeof(settings.split));
+
+        auto hash_files = [&](std::string_view const& name, std::map<std::string, input_file> const& files)
+        {
+            key = generation_manifest::hash(key, name);
+
+            for (auto&& [path, file] : files)
+            {
+                key = generation_manifest::hash(key, path);
+                key = generation_manifest::hash(key, &file.hash, sizeof(file.hash));
+            }
+        };
+
+        hash_files("input", settings.input);
+        hash_files("reference", settings.reference);
+
+        return generation_manifest::hash_file(key, "base.h");
+    }
+
+    // Rough estimate of how long a namespace takes to generate, used to start the most
+    // expensive namespaces first. Methods and fields of the Apis classes dominate.
+    static uint64_t estimate_cost(cache::namespace_members const& members)
+    {
+        uint64_t cost = members.types.size();
+
+        for (auto&& type : members.classes)
+        {
+            cost += size(type.MethodList()) + size(type.FieldList());
+        }
+
+        for (auto&& type : members.structs)
+        {
+            cost += size(type.FieldList());
+        }
+
+        for (auto&& type : members.interfaces)
+        {
+            cost += size(type.MethodList());
+        }
+
+        return cost;
+    }
+
+    static void write_timings(writer& w, task_group const& group, std::chrono::milliseconds const elapsed)
+    {
+        auto timings = group.timings();
+        std::sort(timings.begin(), timings.end(), [](auto&& left, auto&& right)
+            {
+                return left.duration > right.duration;
+            });
+
+        w.write("tasks:     % on % worker(s)\n", static_cast<uint64_t>(timings.size()), group.jobs());
+
+        for (auto&& timing : timings)
+        {
+            w.write("  %ms (start %ms, worker %) %\n",
+                static_cast<int64_t>(timing.duration.count()),
+                static_cast<int64_t>(timing.start.count()),
+                timing.worker,
+                timing.name);
+        }
+
+        w.write("time:      %ms\n", static_cast<int64_t>(elapsed.count()));
+    }
+
     static int run(int const argc, char* argv[])
     {
         int result{};
@@ -158,7 +515,7 @@ Where <spec> is one or more of:
 
         try
         {
-            auto const start_time = std::chrono::high_resolution_clock::now();
+            auto const start_time = std::chrono::steady_clock::now();
 
             reader args{ argc, argv, options };
 
@@ -168,25 +525,144 @@ Where <spec> is one or more of:
             }
 
             process_args(args);
-            cache c{ get_files_to_cache() };
-            task_group group;
+
+            if (!settings.profile.empty())
+            {
+                // Reading the arguments maps and hashes the input files, before -profile is known.
+                profile.start(start_time);
+                profile.add("process_args", {}, start_time, std::chrono::steady_clock::now());
+                count_allocations = true;
+            }
+
+            if (!settings.report.empty())
+            {
+                report.start();
+            }
+
+            auto const manifest_path = get_manifest_path();
+            auto const manifest_key = [&]
+            {
+                auto span = profile.measure("get_manifest_key");
+                return get_manifest_key();
+            }();
+
+            // The report describes the headers as they are written, so it needs a full run.
+            auto const up_to_date = !settings.force && !report.enabled() && [&]
+            {
+                auto span = profile.measure("check_manifest");
+                return manifest.up_to_date(manifest_path, manifest_key);
+            }();
+
+            if (up_to_date)
+            {
+                if (profile.enabled())
+                {
+                    count_allocations = false;
+                    profile.set_counter("allocations", allocation_count);
+                    profile.save(settings.profile);
+                }
+
+                if (settings.verbose)
+                {
+                    w.write("output:    up to date\n");
+                }
+
+                w.flush_to_console();
+                return result;
+            }
+
+            std::filesystem::remove(manifest_path);
+            cache c{ take_files_to_cache(), settings.jobs };
+            c.count_finds(profile.enabled());
+
+            for (auto&& phase : c.phases())
+            {
+                profile.add(phase.name, phase.detail, phase.start, phase.end);
+            }
+
+            auto const namespaces = get_projection(c);
+            task_group group{ settings.jobs };
 
             w.flush_to_console();
 
-            for (auto&& [ns, members] : c.namespaces())
+            definition_units const structs = [&]
+            {
+                auto span = profile.measure("get_struct_units");
+                return get_struct_units(namespaces);
+            }();
+
+            definition_units const interfaces = [&]
+            {
+                auto span = profile.measure("get_interface_units");
+                return get_interface_units(namespaces);
+            }();
+
+            for (auto&& [name, unit] : structs.units)
+            {
+                group.add([&, &name = name, &unit = unit]
+                    {
+                        auto span = profile.measure("write_structs_h", name);
+                        write_structs_h(name, unit);
+                    }, std::string{ name } + ".structs", unit.types.size());
+            }
+
+            for (auto&& [name, unit] : interfaces.units)
+            {
+                group.add([&, &name = name, &unit = unit]
+                    {
+                        auto span = profile.measure("write_interfaces_h", name);
+                        write_interfaces_h(name, unit);
+                    }, std::string{ name } + ".interfaces", unit.types.size());
+            }
+
+            for (auto&& [ns, members] : namespaces)
             {
                 group.add([&, &ns = ns, &members = members]
                     {
-                        write_namespace_0_h(ns, members);
-                        write_namespace_1_h(ns, members);
-                        write_namespace_2_h(ns, members);
-                        write_namespace_h(ns, members);
-                    });
+                        {
+                            auto span = profile.measure("write_namespace_0_h", ns);
+                            write_namespace_0_h(ns, members);
+                        }
+                        {
+                            auto span = profile.measure("write_namespace_1_h", ns);
+                            write_namespace_1_h(ns, members, structs);
+                        }
+                        {
+                            auto span = profile.measure("write_namespace_2_h", ns);
+                            write_namespace_2_h(ns, members, interfaces);
+                        }
+                        {
+                            auto span = profile.measure("write_namespace_h", ns);
+                            write_namespace_h(ns, members);
+                        }
+                    }, std::string{ ns }, estimate_cost(members));
             }
-            group.add([&c] { write_complex_structs_h(c); });
-            group.add([&c] { write_complex_interfaces_h(c); });
+
+            group.get();
 
             std::filesystem::copy_file("base.h", settings.output_folder + "win32/" + "base.h", std::filesystem::copy_options::overwrite_existing);
+            manifest.add_file(settings.output_folder + "win32/" + "base.h");
+            manifest.save(manifest_path, manifest_key);
+
+            if (report.enabled())
+            {
+                report.add("base.h", std::filesystem::file_size("base.h"), {}, {});
+                report.save(settings.report);
+            }
+
+            if (profile.enabled())
+            {
+                count_allocations = false;
+                profile.set_counter("find_calls", c.find_calls());
+                profile.set_counter("extern_type_refs", c.extern_type_refs().size());
+                profile.set_counter("allocations", allocation_count);
+                profile.save(settings.profile);
+            }
+
+            if (settings.verbose)
+            {
+                write_timings(w, group, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time));
+            }
         }
         catch (usage_exception const&)
         {
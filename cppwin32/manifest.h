@@ -0,0 +1,112 @@
+#pragma once
+
+#include <charconv>
+#include <mutex>
+
+namespace cppwin32
+{
+    // Records the inputs and outputs of a run so that an identical rerun can be skipped
+    // without loading any metadata.
+    struct generation_manifest
+    {
+        static constexpr uint64_t hash_seed = 14695981039346656037ull;
+
+        static uint64_t hash(uint64_t value, void const* data, size_t const size) noexcept
+        {
+            auto const bytes = static_cast<uint8_t const*>(data);
+
+            for (size_t i{}; i != size; ++i)
+            {
+                value = (value ^ bytes[i]) * 1099511628211ull;
+            }
+
+            return value;
+        }
+
+        static uint64_t hash(uint64_t value, std::string_view const& text) noexcept
+        {
+            // Include the length so that adjacent strings can't alias each other.
+            auto const size = static_cast<uint64_t>(text.size());
+            value = hash(value, &size, sizeof(size));
+            return hash(value, text.data(), text.size());
+        }
+
+        static uint64_t hash_file(uint64_t value, std::string const& filename)
+        {
+            winmd::reader::file_view file{ filename };
+            value = hash(value, filename);
+            return hash(value, file.begin(), file.size());
+        }
+
+        void add_file(std::string_view filename)
+        {
+            if (winmd::impl::starts_with(filename, settings.output_folder))
+            {
+                filename.remove_prefix(settings.output_folder.size());
+            }
+
+            std::lock_guard guard(m_lock);
+            m_files.emplace(filename);
+        }
+
+        bool up_to_date(std::string const& filename, uint64_t const key) const
+        {
+            std::ifstream file{ filename };
+            std::string line;
+
+            if (!std::getline(file, line) || line != header())
+            {
+                return false;
+            }
+
+            if (!std::getline(file, line) || line != format_key(key))
+            {
+                return false;
+            }
+
+            bool any{};
+
+            while (std::getline(file, line))
+            {
+                if (!std::filesystem::exists(settings.output_folder + line))
+                {
+                    return false;
+                }
+
+                any = true;
+            }
+
+            return any;
+        }
+
+        void save(std::string const& filename, uint64_t const key) const
+        {
+            std::ofstream file{ filename, std::ios::out | std::ios::binary };
+            file << header() << '\n' << format_key(key) << '\n';
+
+            for (auto&& output : m_files)
+            {
+                file << output << '\n';
+            }
+        }
+
+    private:
+
+        static std::string header()
+        {
+            return std::string{ "cppwin32 " } + CPPWIN32_VERSION_STRING;
+        }
+
+        static std::string format_key(uint64_t const key)
+        {
+            char buffer[17]{};
+            auto end = std::to_chars(std::begin(buffer), std::end(buffer), key, 16).ptr;
+            return std::string{ "key " } + std::string{ buffer, static_cast<size_t>(end - buffer) };
+        }
+
+        std::mutex m_lock;
+        std::set<std::string> m_files;
+    };
+
+    extern generation_manifest manifest;
+}
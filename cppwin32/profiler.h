@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace cppwin32
+{
+    struct trace_writer : writer_base<trace_writer>
+    {
+        using writer_base<trace_writer>::write;
+    };
+
+    static void write_escaped(trace_writer& w, std::string_view const& value)
+    {
+        for (auto&& c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                w.write('\\');
+            }
+
+            w.write(c);
+        }
+    }
+
+    // Records a timeline of spans and a set of counters for the -profile option. The output is
+    // Chrome trace-event JSON and can be opened in chrome://tracing or https://ui.perfetto.dev.
+    struct profiler
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct span
+        {
+            span(span const&) = delete;
+            span& operator=(span const&) = delete;
+
+            span(profiler* owner, std::string_view const& name, std::string_view const& detail) :
+                m_owner(owner),
+                m_name(name),
+                m_detail(detail),
+                m_start(owner ? clock::now() : clock::time_point{})
+            {
+            }
+
+            ~span()
+            {
+                if (m_owner)
+                {
+                    m_owner->add(m_name, m_detail, m_start, clock::now());
+                }
+            }
+
+        private:
+
+            profiler* m_owner;
+            std::string_view m_name;
+            std::string_view m_detail;
+            clock::time_point m_start;
+        };
+
+        void start(clock::time_point const start) noexcept
+        {
+            m_start = start;
+            m_enabled = true;
+        }
+
+        bool enabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        // The name and detail must outlive the span.
+        [[nodiscard]] span measure(std::string_view const& name, std::string_view const& detail = {})
+        {
+            return { m_enabled ? this : nullptr, name, detail };
+        }
+
+        void add(std::string_view const& name, std::string_view const& detail, clock::time_point const start, clock::time_point const end)
+        {
+            if (!m_enabled)
+            {
+                return;
+            }
+
+            auto const thread = thread_index();
+            std::lock_guard guard(m_lock);
+            m_events.push_back({ std::string{ name }, std::string{ detail }, start, end, thread });
+        }
+
+        void add_file(size_t const bytes, bool const written) noexcept
+        {
+            if (m_enabled)
+            {
+                m_bytes_emitted.fetch_add(bytes, std::memory_order_relaxed);
+                (written ? m_files_written : m_files_skipped).fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void set_counter(std::string_view const& name, uint64_t const value)
+        {
+            std::lock_guard guard(m_lock);
+            m_counters.insert_or_assign(std::string{ name }, value);
+        }
+
+        void save(std::string const& filename)
+        {
+            set_counter("bytes_emitted", m_bytes_emitted);
+            set_counter("files_written", m_files_written);
+            set_counter("files_skipped", m_files_skipped);
+
+            std::lock_guard guard(m_lock);
+            std::sort(m_events.begin(), m_events.end(), [](event const& left, event const& right)
+                {
+                    return left.start < right.start;
+                });
+
+            trace_writer w;
+            w.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+            auto end = m_start;
+
+            for (auto&& event : m_events)
+            {
+                w.write(R"({"name":"%","cat":"cppwin32","ph":"X","pid":1,"tid":%,"ts":%,"dur":%)",
+                    bind<write_escaped>(event.name),
+                    event.thread,
+                    microseconds(event.start),
+                    microseconds(event.end) - microseconds(event.start));
+
+                if (!event.detail.empty())
+                {
+                    w.write(R"(,"args":{"detail":"%"})", bind<write_escaped>(event.detail));
+                }
+
+                w.write("},\n");
+                end = (std::max)(end, event.end);
+            }
+
+            w.write(R"({"name":"counters","ph":"C","pid":1,"tid":0,"ts":%,"args":{)", microseconds(end));
+            bool first{ true };
+
+            for (auto&& [name, value] : m_counters)
+            {
+                w.write(R"(%"%":%)", first ? "" : ",", name, value);
+                first = false;
+            }
+
+            w.write("}}\n]}\n");
+            w.flush_to_file(filename);
+        }
+
+    private:
+
+        struct event
+        {
+            std::string name;
+            std::string detail;
+            clock::time_point start;
+            clock::time_point end;
+            uint32_t thread{};
+        };
+
+        static uint32_t thread_index() noexcept
+        {
+            static std::atomic<uint32_t> next{};
+            thread_local uint32_t const index = next++;
+            return index;
+        }
+
+        int64_t microseconds(clock::time_point const time) const noexcept
+        {
+            return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time - m_start).count());
+        }
+
+        bool m_enabled{};
+        clock::time_point m_start;
+        std::mutex m_lock;
+        std::vector<event> m_events;
+        std::map<std::string, uint64_t> m_counters;
+        std::atomic<uint64_t> m_bytes_emitted{};
+        std::atomic<uint64_t> m_files_written{};
+        std::atomic<uint64_t> m_files_skipped{};
+    };
+
+    extern profiler profile;
+}
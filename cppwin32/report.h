@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <numeric>
+
+namespace cppwin32
+{
+    enum class declaration_kind
+    {
+        enum_type,
+        struct_type,
+        interface_type,
+        delegate,
+        forward,
+        guid,
+        abi_function,
+        function,
+        constant,
+        count
+    };
+
+    struct report_writer : writer_base<report_writer>
+    {
+        using writer_base<report_writer>::write;
+    };
+
+    // Records each generated header's size, declarations and includes for the -report option.
+    // The report adds the size of each header's transitive include closure and ranks the headers
+    // by how many bytes they add to the closures of the headers that include them.
+    struct header_report
+    {
+        using declaration_counts = std::array<uint32_t, static_cast<size_t>(declaration_kind::count)>;
+
+        void start() noexcept
+        {
+            m_enabled = true;
+        }
+
+        bool enabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        // Headers are named relative to the win32 folder, as they are included.
+        void add(std::string_view filename, uint64_t const bytes, declaration_counts const& declarations, std::vector<std::string>&& includes)
+        {
+            if (!m_enabled)
+            {
+                return;
+            }
+
+            if (winmd::impl::starts_with(filename, settings.output_folder))
+            {
+                filename.remove_prefix(settings.output_folder.size());
+            }
+
+            if (winmd::impl::starts_with(filename, "win32/"))
+            {
+                filename.remove_prefix(6);
+            }
+
+            std::lock_guard guard(m_lock);
+            m_headers.insert_or_assign(std::string{ filename }, header{ bytes, declarations, std::move(includes) });
+        }
+
+        void save(std::string const& filename)
+        {
+            std::lock_guard guard(m_lock);
+            std::vector<std::pair<std::string const, header>*> headers;
+            std::map<std::string_view, uint32_t> indexes;
+
+            for (auto&& entry : m_headers)
+            {
+                indexes.emplace(entry.first, static_cast<uint32_t>(headers.size()));
+                headers.push_back(&entry);
+            }
+
+            // Includes of files that weren't generated, such as the precompiled header, are left out.
+            std::vector<std::vector<uint32_t>> edges(headers.size());
+
+            for (uint32_t index{}; index != headers.size(); ++index)
+            {
+                for (auto&& include : headers[index]->second.includes)
+                {
+                    if (auto const target = indexes.find(include); target != indexes.end())
+                    {
+                        edges[index].push_back(target->second);
+                    }
+                }
+            }
+
+            struct closure
+            {
+                uint32_t headers{};
+                uint64_t bytes{};
+                uint32_t included_by{};
+            };
+
+            std::vector<closure> closures(headers.size());
+            std::vector<uint32_t> visited(headers.size(), UINT32_MAX);
+            std::vector<uint32_t> pending;
+
+            for (uint32_t index{}; index != headers.size(); ++index)
+            {
+                visited[index] = index;
+                pending.push_back(index);
+
+                while (!pending.empty())
+                {
+                    auto const current = pending.back();
+                    pending.pop_back();
+                    ++closures[index].headers;
+                    closures[index].bytes += headers[current]->second.bytes;
+
+                    if (current != index)
+                    {
+                        ++closures[current].included_by;
+                    }
+
+                    for (auto&& edge : edges[current])
+                    {
+                        if (visited[edge] != index)
+                        {
+                            visited[edge] = index;
+                            pending.push_back(edge);
+                        }
+                    }
+                }
+            }
+
+            auto added_bytes = [&](uint32_t const index)
+            {
+                return closures[index].included_by * headers[index]->second.bytes;
+            };
+
+            std::vector<uint32_t> order(headers.size());
+            std::iota(order.begin(), order.end(), 0);
+            report_writer w;
+            uint64_t total_bytes{};
+
+            for (auto&& header : headers)
+            {
+                total_bytes += header->second.bytes;
+            }
+
+            w.write("headers: %, % bytes\n\n", static_cast<uint64_t>(headers.size()), total_bytes);
+
+            std::sort(order.begin(), order.end(), [&](uint32_t const left, uint32_t const right)
+                {
+                    return added_bytes(left) > added_bytes(right);
+                });
+
+            w.write("most bytes added to other headers' closures (bytes x included by):\n");
+
+            for (size_t rank{}; rank != (std::min)(order.size(), size_t{ 20 }) && added_bytes(order[rank]); ++rank)
+            {
+                auto const index = order[rank];
+                w.write("  % bytes (% x %) %\n",
+                    added_bytes(index),
+                    headers[index]->second.bytes,
+                    closures[index].included_by,
+                    headers[index]->first);
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t const left, uint32_t const right)
+                {
+                    return closures[left].bytes > closures[right].bytes;
+                });
+
+            for (auto&& index : order)
+            {
+                auto const& [name, header] = *headers[index];
+                w.write("\n%\n  bytes: %\n  closure: % headers, % bytes\n  included by: %\n  declarations:",
+                    name,
+                    header.bytes,
+                    closures[index].headers,
+                    closures[index].bytes,
+                    closures[index].included_by);
+
+                for (size_t kind{}; kind != header.declarations.size(); ++kind)
+                {
+                    if (header.declarations[kind])
+                    {
+                        w.write(" % %", declaration_names[kind], header.declarations[kind]);
+                    }
+                }
+
+                w.write("\n  includes:");
+
+                for (auto&& include : header.includes)
+                {
+                    w.write(" %", include);
+                }
+
+                w.write("\n");
+            }
+
+            w.flush_to_file(filename);
+        }
+
+    private:
+
+        static constexpr std::string_view declaration_names[]
+        {
+            "enums",
+            "structs",
+            "interfaces",
+            "delegates",
+            "forwards",
+            "guids",
+            "abi_functions",
+            "functions",
+            "constants",
+        };
+
+        static_assert(std::size(declaration_names) == static_cast<size_t>(declaration_kind::count));
+
+        struct header
+        {
+            uint64_t bytes{};
+            declaration_counts declarations{};
+            std::vector<std::string> includes;
+        };
+
+        bool m_enabled{};
+        std::mutex m_lock;
+        std::map<std::string, header> m_headers;
+    };
+
+    extern header_report report;
+}
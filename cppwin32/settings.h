@@ -2,16 +2,37 @@
 
 namespace cppwin32
 {
+    // A metadata file that reader::files has mapped, checked and hashed.
+    struct input_file
+    {
+        winmd::reader::file_view view;
+        uint64_t hash{};
+    };
+
+    // How the functions of each namespace are split into headers by -split.
+    enum class api_split
+    {
+        none,
+        module,
+        prefix,
+    };
+
     struct settings_type
     {
-        std::set<std::string> input;
-        std::set<std::string> reference;
+        std::map<std::string, input_file> input;
+        std::map<std::string, input_file> reference;
 
         std::string output_folder;
         bool base{};
+        bool force{};
         bool license{};
         bool brackets{};
+        bool flags{};
+        api_split split{};
         bool verbose{};
+        uint32_t jobs{};
+        std::string profile;
+        std::string report;
         bool component{};
         std::string component_folder;
         std::string component_name;
@@ -24,10 +45,15 @@ namespace cppwin32
 
         std::set<std::string> include;
         std::set<std::string> exclude;
+        std::set<std::string> roots;
 
         winmd::reader::filter projection_filter;
         winmd::reader::filter component_filter;
 
+        // The functions and constants that -roots needs; the types are applied to the namespaces.
+        std::set<winmd::reader::MethodDef> root_functions;
+        std::set<winmd::reader::Field> root_constants;
+
         bool fastabi{};
         std::map<winmd::reader::TypeDef, winmd::reader::TypeDef> fastabi_cache;
     };
@@ -1,49 +1,211 @@
 #pragma once
 
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 namespace cppwin32
 {
     struct task_group
     {
+        struct timing
+        {
+            std::string name;
+            std::chrono::milliseconds start;
+            std::chrono::milliseconds duration;
+            uint32_t worker{};
+        };
+
         task_group(task_group const&) = delete;
         task_group& operator=(task_group const&) = delete;
 
-        task_group() noexcept = default;
+        explicit task_group(uint32_t jobs = 0) noexcept : m_jobs(jobs)
+        {
+            if (m_jobs == 0)
+            {
+                m_jobs = (std::max)(1u, std::thread::hardware_concurrency());
+            }
+        }
 
         ~task_group() noexcept
         {
-            for (auto&& task : m_tasks)
+            try
+            {
+                get();
+            }
+            catch (...)
             {
-                task.wait();
             }
         }
 
+        // Tasks with a higher cost are started first so that the longest running
+        // work does not end up at the tail of the run.
         template <typename T>
-        void add(T&& callback)
+        void add(T&& callback, std::string name = {}, uint64_t cost = 0)
         {
 #if defined(_DEBUG)
-            callback();
+            task debug_task{ std::forward<T>(callback), std::move(name), cost };
+            run(debug_task, 0, std::chrono::steady_clock::now());
 #else
-            m_tasks.push_back(std::async(std::forward<T>(callback)));
+            m_tasks.push_back({ std::forward<T>(callback), std::move(name), cost });
 #endif
         }
 
         void get()
         {
             auto tasks = std::move(m_tasks);
+            m_tasks.clear();
+
+            if (tasks.empty())
+            {
+                rethrow();
+                return;
+            }
+
+            std::stable_sort(tasks.begin(), tasks.end(), [](task const& left, task const& right)
+                {
+                    return left.cost > right.cost;
+                });
+
+            auto const worker_count = static_cast<uint32_t>((std::min)(static_cast<size_t>(m_jobs), tasks.size()));
+            std::vector<worker_queue> queues(worker_count);
+
+            // Deal the sorted tasks round-robin so every worker starts on one of the most expensive tasks.
+            for (size_t i{}; i != tasks.size(); ++i)
+            {
+                queues[i % worker_count].tasks.push_back(std::move(tasks[i]));
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            threads.reserve(worker_count - 1);
 
-            for (auto&& task : tasks)
+            for (uint32_t i = 1; i < worker_count; ++i)
             {
-                task.wait();
+                threads.emplace_back([&, i] { work(queues, i, start); });
             }
 
-            for (auto&& task : tasks)
+            work(queues, 0, start);
+
+            for (auto&& thread : threads)
             {
-                task.get();
+                thread.join();
             }
+
+            rethrow();
+        }
+
+        uint32_t jobs() const noexcept
+        {
+            return m_jobs;
+        }
+
+        std::vector<timing> const& timings() const noexcept
+        {
+            return m_timings;
         }
 
     private:
 
-        std::vector<std::future<void>> m_tasks;
+        struct task
+        {
+            std::function<void()> callback;
+            std::string name;
+            uint64_t cost{};
+        };
+
+        struct worker_queue
+        {
+            std::mutex lock;
+            std::deque<task> tasks;
+        };
+
+        void work(std::vector<worker_queue>& queues, uint32_t const index, std::chrono::steady_clock::time_point const start)
+        {
+            task current;
+
+            while (pop(queues, index, current))
+            {
+                run(current, index, start);
+            }
+        }
+
+        // Takes the most expensive task from the worker's own queue, or steals the
+        // cheapest task from another worker once its own queue has been drained.
+        static bool pop(std::vector<worker_queue>& queues, uint32_t const index, task& result)
+        {
+            {
+                auto& own = queues[index];
+                std::lock_guard guard(own.lock);
+
+                if (!own.tasks.empty())
+                {
+                    result = std::move(own.tasks.front());
+                    own.tasks.pop_front();
+                    return true;
+                }
+            }
+
+            for (size_t offset = 1; offset != queues.size(); ++offset)
+            {
+                auto& victim = queues[(index + offset) % queues.size()];
+                std::lock_guard guard(victim.lock);
+
+                if (!victim.tasks.empty())
+                {
+                    result = std::move(victim.tasks.back());
+                    victim.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void run(task& current, uint32_t const worker, std::chrono::steady_clock::time_point const start)
+        {
+            auto const task_start = std::chrono::steady_clock::now();
+
+            try
+            {
+                current.callback();
+            }
+            catch (...)
+            {
+                std::lock_guard guard(m_lock);
+
+                if (!m_exception)
+                {
+                    m_exception = std::current_exception();
+                }
+            }
+
+            auto const task_end = std::chrono::steady_clock::now();
+            std::lock_guard guard(m_lock);
+
+            m_timings.push_back({
+                std::move(current.name),
+                std::chrono::duration_cast<std::chrono::milliseconds>(task_start - start),
+                std::chrono::duration_cast<std::chrono::milliseconds>(task_end - task_start),
+                worker });
+        }
+
+        void rethrow()
+        {
+            if (auto exception = std::exchange(m_exception, nullptr))
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        uint32_t m_jobs{};
+        std::vector<task> m_tasks;
+        std::mutex m_lock;
+        std::exception_ptr m_exception;
+        std::vector<timing> m_timings;
     };
 }
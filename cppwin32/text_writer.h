@@ -1,67 +1,238 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <charconv>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <list>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 namespace cppwin32
 {
-    inline std::string file_to_string(std::string const& filename)
+    // Compares the next buffer.size() bytes of the stream against the buffer without
+    // reading the whole file into memory.
+    inline bool stream_equal(std::istream& stream, std::vector<char> const& buffer)
     {
-        std::ifstream file(filename, std::ios::binary);
-        return static_cast<std::stringstream const&>(std::stringstream() << file.rdbuf()).str();
+        std::array<char, 64 * 1024> chunk;
+        size_t offset{};
+
+        while (offset != buffer.size())
+        {
+            auto const count = (std::min)(chunk.size(), buffer.size() - offset);
+
+            if (!stream.read(chunk.data(), count))
+            {
+                return false;
+            }
+
+            if (0 != memcmp(chunk.data(), buffer.data() + offset, count))
+            {
+                return false;
+            }
+
+            offset += count;
+        }
+
+        return true;
     }
 
+    // A format string that is split into literal text and placeholders at compile time.
+    // '%' writes the next argument, '@' writes the next (text) argument as code, and '^'
+    // escapes the character that follows it. A format that does not match its arguments
+    // fails to compile.
+    template <typename... Args>
+    struct format_string
+    {
+        struct segment
+        {
+            uint32_t offset{};
+            uint32_t size{};
+            bool escaped{};
+            char placeholder{};
+        };
+
+        consteval format_string(char const* const value) : text(value)
+        {
+            constexpr bool is_text[]{ std::is_convertible_v<Args, std::string_view>..., false };
+            uint32_t count{};
+            uint32_t start{};
+            bool escaped{};
+
+            for (uint32_t i{}; i != text.size(); ++i)
+            {
+                auto const c = text[i];
+
+                if (c == '^')
+                {
+                    if (i + 1 == text.size())
+                    {
+                        throw "Format ends with an escape character";
+                    }
+
+                    escaped = true;
+                    ++i;
+                }
+                else if (c == '%' || c == '@')
+                {
+                    if (count == sizeof...(Args))
+                    {
+                        throw "Format has more placeholders than arguments";
+                    }
+
+                    if (c == '@' && !is_text[count])
+                    {
+                        throw "Format has an '@' placeholder for an argument that is not text";
+                    }
+
+                    segments[count++] = { start, i - start, escaped, c };
+                    start = i + 1;
+                    escaped = false;
+                }
+            }
+
+            if (count != sizeof...(Args))
+            {
+                throw "Format has fewer placeholders than arguments";
+            }
+
+            segments[count] = { start, static_cast<uint32_t>(text.size()) - start, escaped, 0 };
+        }
+
+        std::string_view text;
+
+        // The literal text preceding each placeholder, followed by the trailing text.
+        std::array<segment, sizeof...(Args) + 1> segments{};
+    };
+
     template <typename T>
     struct writer_base
     {
         writer_base(writer_base const&) = delete;
         writer_base& operator=(writer_base const&) = delete;
 
+        // Output is kept in a list of fixed-capacity chunks so that large headers never
+        // reallocate and copy, and so that text can be inserted at an earlier position.
+        static constexpr size_t chunk_size = 64 * 1024;
+        static constexpr size_t scratch_size = 4 * 1024;
+        static constexpr size_t pooled_chunks = 16;
+        using chunk_list = std::list<std::vector<char>>;
+
+        // A position in the output that can be written to later, typically the prologue of
+        // a file whose includes are only known once the body has been written.
+        struct insertion_point
+        {
+            typename chunk_list::iterator chunk;
+        };
+
+        struct insertion_guard
+        {
+            insertion_guard(writer_base<T>& w, insertion_point& point) noexcept :
+                m_writer(w), m_point(point), m_previous(std::exchange(w.m_current, point.chunk))
+            {
+            }
+
+            ~insertion_guard() noexcept
+            {
+                m_point.chunk = std::exchange(m_writer.m_current, m_previous);
+            }
+
+            insertion_guard(insertion_guard const&) = delete;
+            insertion_guard& operator=(insertion_guard const&) = delete;
+
+        private:
+            writer_base<T>& m_writer;
+            insertion_point& m_point;
+            typename chunk_list::iterator m_previous;
+        };
+
         writer_base()
         {
-            m_first.reserve(16 * 1024);
+            reset();
+        }
+
+        ~writer_base() noexcept
+        {
+            recycle();
+        }
+
+        [[nodiscard]] insertion_point add_insertion_point()
+        {
+            auto point = take_chunk(std::next(m_current));
+            m_current = take_chunk(std::next(point));
+            return { point };
+        }
+
+        // Redirects all writes to the insertion point until the guard goes out of scope.
+        [[nodiscard]] insertion_guard write_at(insertion_point& point) noexcept
+        {
+            return { *this, point };
         }
 
         template <typename... Args>
-        void write(std::string_view const& value, Args const&... args)
+        void write(format_string<std::type_identity_t<Args>...> const& value, Args const&... args)
         {
-#if defined(_DEBUG)
-            auto expected = count_placeholders(value);
-            auto actual = sizeof...(Args);
-            assert(expected == actual);
-#endif
-            write_segment(value, args...);
+            write_format(value, std::index_sequence_for<Args...>{}, args...);
         }
 
+        // Formats into a scratch region rather than the output. The result stays valid, and
+        // is null terminated, until the writer is flushed.
         template <typename... Args>
-        std::string write_temp(std::string_view const& value, Args const&... args)
+        std::string_view write_temp(format_string<std::type_identity_t<Args>...> const& value, Args const&... args)
         {
 #if defined(_DEBUG)
             bool restore_debug_trace = debug_trace;
             debug_trace = false;
 #endif
-            auto const size = m_first.size();
+            auto const first = m_current;
+            auto const size = first->size();
+
+            write_format(value, std::index_sequence_for<Args...>{}, args...);
+
+            // Chunks added while writing always directly follow the chunk that was current.
+            auto const last = std::next(m_current);
+            auto length = first->size() - size;
+
+            for (auto chunk = std::next(first); chunk != last; ++chunk)
+            {
+                length += chunk->size();
+            }
 
-            assert(count_placeholders(value) == sizeof...(Args));
-            write_segment(value, args...);
+            auto const result = allocate_scratch(length + 1);
+            auto cursor = std::copy(first->begin() + size, first->end(), result);
+            first->resize(size);
 
-            std::string result{ m_first.data() + size, m_first.size() - size };
-            m_first.resize(size);
+            for (auto chunk = std::next(first); chunk != last;)
+            {
+                cursor = std::copy(chunk->begin(), chunk->end(), cursor);
+                chunk = m_chunks.erase(chunk);
+            }
+
+            *cursor = 0;
+            m_current = first;
 
 #if defined(_DEBUG)
             debug_trace = restore_debug_trace;
 #endif
-            return result;
+            return { result, length };
         }
 
         void write_impl(std::string_view const& value)
         {
-            m_first.insert(m_first.end(), value.begin(), value.end());
+            auto& chunk = prepare(value.size());
+            chunk.insert(chunk.end(), value.begin(), value.end());
 
 #if defined(_DEBUG)
             if (debug_trace)
@@ -73,7 +244,7 @@ namespace cppwin32
 
         void write_impl(char const value)
         {
-            m_first.push_back(value);
+            prepare(1).push_back(value);
 
 #if defined(_DEBUG)
             if (debug_trace)
@@ -106,29 +277,33 @@ namespace cppwin32
 
         void write(int32_t const value)
         {
-            write(std::to_string(value));
+            write_integer(value);
         }
 
         void write(uint32_t const value)
         {
-            write(std::to_string(value));
+            write_integer(value);
         }
 
         void write(int64_t const value)
         {
-            write(std::to_string(value));
+            write_integer(value);
         }
 
         void write(uint64_t const value)
         {
-            write(std::to_string(value));
+            write_integer(value);
         }
 
         template <typename... Args>
         void write_printf(char const* format, Args const&... args)
         {
             char buffer[128];
+#if defined(_WIN32)
             size_t const size = sprintf_s(buffer, format, args...);
+#else
+            size_t const size = (std::min)(sizeof(buffer) - 1, static_cast<size_t>(snprintf(buffer, sizeof(buffer), format, args...)));
+#endif
             write(std::string_view{ buffer, size });
         }
 
@@ -141,72 +316,100 @@ namespace cppwin32
             }
         }
 
-        void swap() noexcept
-        {
-            std::swap(m_second, m_first);
-        }
-
         void flush_to_console(bool to_stdout = true) noexcept
         {
-            fprintf(to_stdout ? stdout : stderr, "%.*s", static_cast<int>(m_first.size()), m_first.data());
-            fprintf(to_stdout ? stdout : stderr, "%.*s", static_cast<int>(m_second.size()), m_second.data());
-            m_first.clear();
-            m_second.clear();
+            for (auto&& chunk : m_chunks)
+            {
+                fprintf(to_stdout ? stdout : stderr, "%.*s", static_cast<int>(chunk.size()), chunk.data());
+            }
+
+            reset();
         }
 
-        void flush_to_file(std::string const& filename)
+        // Returns false if the file already had the same content and was left untouched.
+        bool flush_to_file(std::string const& filename)
         {
-            if (!file_equal(filename))
+            bool const written = !file_equal(filename);
+
+            if (written)
             {
-                std::ofstream file{ filename, std::ios::out | std::ios::binary };
-                file.write(m_first.data(), m_first.size());
-                file.write(m_second.data(), m_second.size());
+                // Write to a temporary file and rename it into place so that readers never
+                // observe a partially written header.
+                temp_file temp{ filename + ".tmp" };
+                write_chunks(temp.filename);
+                std::filesystem::rename(temp.filename, filename);
+                temp.filename.clear();
             }
-            m_first.clear();
-            m_second.clear();
+
+            reset();
+            return written;
         }
 
-        void flush_to_file(std::filesystem::path const& filename)
+        bool flush_to_file(std::filesystem::path const& filename)
         {
-            flush_to_file(filename.string());
+            return flush_to_file(filename.string());
         }
 
         std::string flush_to_string()
         {
             std::string result;
-            result.reserve(m_first.size() + m_second.size());
-            result.assign(m_first.begin(), m_first.end());
-            result.append(m_second.begin(), m_second.end());
-            m_first.clear();
-            m_second.clear();
+            result.reserve(size());
+
+            for (auto&& chunk : m_chunks)
+            {
+                result.append(chunk.begin(), chunk.end());
+            }
+
+            reset();
             return result;
         }
 
         char back()
         {
-            return m_first.empty() ? char{} : m_first.back();
+            for (auto chunk = std::make_reverse_iterator(std::next(m_current)); chunk != m_chunks.rend(); ++chunk)
+            {
+                if (!chunk->empty())
+                {
+                    return chunk->back();
+                }
+            }
+
+            return {};
         }
 
-        bool file_equal(std::string const& filename) const
+        size_t size() const noexcept
         {
-            if (!std::filesystem::exists(filename))
+            size_t result{};
+
+            for (auto&& chunk : m_chunks)
             {
-                return false;
+                result += chunk.size();
             }
 
-            auto file = file_to_string(filename);
+            return result;
+        }
+
+        bool file_equal(std::string const& filename) const
+        {
+            std::error_code error;
+            auto const size = std::filesystem::file_size(filename, error);
 
-            if (file.size() != m_first.size() + m_second.size())
+            if (error || size != this->size())
             {
                 return false;
             }
 
-            if (!std::equal(m_first.begin(), m_first.end(), file.begin(), file.begin() + m_first.size()))
+            std::ifstream file{ filename, std::ios::binary };
+
+            for (auto&& chunk : m_chunks)
             {
-                return false;
+                if (!stream_equal(file, chunk))
+                {
+                    return false;
+                }
             }
 
-            return std::equal(m_second.begin(), m_second.end(), file.begin() + m_first.size(), file.end());
+            return true;
         }
 
 #if defined(_DEBUG)
@@ -215,87 +418,248 @@ namespace cppwin32
 
     private:
 
-        static constexpr uint32_t count_placeholders(std::string_view const& format) noexcept
+        // Removes a temporary file that was not renamed into place, such as when writing it throws.
+        struct temp_file
         {
-            uint32_t count{};
-            bool escape{};
+            std::string filename;
 
-            for (auto c : format)
+            ~temp_file() noexcept
             {
-                if (!escape)
+                if (!filename.empty())
                 {
-                    if (c == '^')
-                    {
-                        escape = true;
-                        continue;
-                    }
+                    std::error_code error;
+                    std::filesystem::remove(filename, error);
+                }
+            }
+        };
 
-                    if (c == '%' || c == '@')
-                    {
-                        ++count;
-                    }
+        template <typename... Args, size_t... Index>
+        void write_format(format_string<Args...> const& format, std::index_sequence<Index...>, Args const&... args)
+        {
+            (write_placeholder(format.text, format.segments[Index], args), ...);
+            write_text(format.text, format.segments[sizeof...(Args)]);
+        }
+
+        template <typename Segment, typename Arg>
+        void write_placeholder(std::string_view const& text, Segment const& segment, Arg const& arg)
+        {
+            write_text(text, segment);
+
+            if constexpr (std::is_convertible_v<Arg, std::string_view>)
+            {
+                if (segment.placeholder == '@')
+                {
+                    static_cast<T*>(this)->write_code(arg);
+                    return;
                 }
-                escape = false;
             }
 
-            return count;
+            static_cast<T*>(this)->write(arg);
         }
 
-        void write_segment(std::string_view const& value)
+        template <typename Segment>
+        void write_text(std::string_view const& text, Segment const& segment)
         {
-            auto offset = value.find_first_of("^");
-            if (offset == std::string_view::npos)
+            auto value = text.substr(segment.offset, segment.size);
+
+            if (segment.escaped)
+            {
+                for (auto offset = value.find('^'); offset != std::string_view::npos; offset = value.find('^'))
+                {
+                    write(value.substr(0, offset));
+                    write(value[offset + 1]);
+                    value = value.substr(offset + 2);
+                }
+            }
+
+            if (!value.empty())
             {
                 write(value);
-                return;
             }
+        }
+
+        // Finished chunks, along with their list nodes, go to a pool for the thread, so that a
+        // writer per header only allocates until the pool is warm.
+        static chunk_list& chunk_pool() noexcept
+        {
+            thread_local chunk_list pool;
+            return pool;
+        }
+
+        static void recycle(chunk_list& chunks) noexcept
+        {
+            auto& pool = chunk_pool();
 
-            write(value.substr(0, offset));
+            while (!chunks.empty())
+            {
+                auto const chunk = chunks.begin();
+                chunk->clear();
+                pool.splice(chunk->capacity() >= chunk_size ? pool.begin() : pool.end(), chunks, chunk);
+            }
 
-            assert(offset != value.size() - 1);
+            while (pool.size() > pooled_chunks)
+            {
+                pool.pop_back();
+            }
+        }
 
-            write(value[offset + 1]);
-            write_segment(value.substr(offset + 2));
+        void recycle() noexcept
+        {
+            recycle(m_chunks);
+            recycle(m_scratch);
         }
 
-        template <typename First, typename... Rest>
-        void write_segment(std::string_view const& value, First const& first, Rest const&... rest)
+        static typename chunk_list::iterator take_chunk(chunk_list& chunks, typename chunk_list::iterator const position)
         {
-            auto offset = value.find_first_of("^%@");
-            assert(offset != std::string_view::npos);
-            write(value.substr(0, offset));
+            auto& pool = chunk_pool();
 
-            if (value[offset] == '^')
+            if (pool.empty())
             {
-                assert(offset != value.size() - 1);
+                return chunks.emplace(position);
+            }
+
+            chunks.splice(position, pool, pool.begin());
+            return std::prev(position);
+        }
+
+        typename chunk_list::iterator take_chunk(typename chunk_list::iterator const position)
+        {
+            return take_chunk(m_chunks, position);
+        }
+
+        void reset()
+        {
+            recycle(m_chunks);
+            m_current = take_chunk(m_chunks.end());
+            m_current->reserve(chunk_size);
 
-                write(value[offset + 1]);
-                write_segment(value.substr(offset + 2), first, rest...);
+            // Scratch chunks keep their capacity so that steady-state write_temp calls don't allocate.
+            for (auto&& chunk : m_scratch)
+            {
+                chunk.clear();
             }
-            else
+
+            m_scratch_current = m_scratch.begin();
+        }
+
+        template <typename V>
+        void write_integer(V const value)
+        {
+            char buffer[24];
+            auto const end = std::to_chars(std::begin(buffer), std::end(buffer), value).ptr;
+            write(std::string_view{ buffer, static_cast<size_t>(end - buffer) });
+        }
+
+        // Scratch chunks never grow past their reserved capacity, so earlier results stay in place.
+        char* allocate_scratch(size_t const count)
+        {
+            for (; m_scratch_current != m_scratch.end(); ++m_scratch_current)
             {
-                if (value[offset] == '%')
+                auto& chunk = *m_scratch_current;
+                auto const offset = chunk.size();
+
+                if (chunk.capacity() - offset >= count)
                 {
-                    static_cast<T*>(this)->write(first);
+                    chunk.resize(offset + count);
+                    return chunk.data() + offset;
                 }
-                else
+            }
+
+            m_scratch_current = take_chunk(m_scratch, m_scratch.end());
+            auto& chunk = *m_scratch_current;
+            chunk.reserve((std::max)(scratch_size, count));
+            chunk.resize(count);
+            return chunk.data();
+        }
+
+        // Returns a chunk at the current position with room for count more characters.
+        std::vector<char>& prepare(size_t const count)
+        {
+            if (m_current->capacity() - m_current->size() >= count)
+            {
+                return *m_current;
+            }
+
+            if (!m_current->empty())
+            {
+                m_current = take_chunk(std::next(m_current));
+            }
+
+            m_current->reserve((std::max)(chunk_size, count));
+            return *m_current;
+        }
+
+        void write_chunks(std::string const& filename) const
+        {
+#if defined(_WIN32)
+            std::ofstream file{ filename, std::ios::out | std::ios::binary };
+
+            for (auto&& chunk : m_chunks)
+            {
+                file.write(chunk.data(), chunk.size());
+            }
+
+            if (!file.flush())
+            {
+                throw std::invalid_argument("Could not write file '" + filename + "'");
+            }
+#else
+            // Gather the chunks into as few writev calls as possible.
+            std::vector<iovec> buffers;
+            buffers.reserve(m_chunks.size());
+
+            for (auto&& chunk : m_chunks)
+            {
+                if (!chunk.empty())
                 {
-                    if constexpr (std::is_convertible_v<First, std::string_view>)
-                    {
-                        static_cast<T*>(this)->write_code(first);
-                    }
-                    else
-                    {
-                        assert(false); // '@' placeholders are only for text.
-                    }
+                    buffers.push_back({ const_cast<char*>(chunk.data()), chunk.size() });
+                }
+            }
+
+            int const file = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            bool success = file != -1;
+
+            for (size_t offset{}; success && offset != buffers.size();)
+            {
+                auto const count = (std::min)(buffers.size() - offset, static_cast<size_t>(IOV_MAX));
+                auto written = writev(file, buffers.data() + offset, static_cast<int>(count));
+
+                if (written < 0)
+                {
+                    success = false;
+                    break;
+                }
+
+                // Skip past fully written buffers and trim a partially written one.
+                while (offset != buffers.size() && static_cast<size_t>(written) >= buffers[offset].iov_len)
+                {
+                    written -= buffers[offset].iov_len;
+                    ++offset;
+                }
+
+                if (written > 0)
+                {
+                    buffers[offset].iov_base = static_cast<char*>(buffers[offset].iov_base) + written;
+                    buffers[offset].iov_len -= written;
                 }
+            }
 
-                write_segment(value.substr(offset + 1), rest...);
+            if (file != -1)
+            {
+                success = (close(file) == 0) && success;
             }
+
+            if (!success)
+            {
+                throw std::invalid_argument("Could not write file '" + filename + "'");
+            }
+#endif
         }
 
-        std::vector<char> m_second;
-        std::vector<char> m_first;
+        chunk_list m_chunks;
+        typename chunk_list::iterator m_current;
+        chunk_list m_scratch;
+        typename chunk_list::iterator m_scratch_current;
     };
 
 
@@ -322,54 +686,51 @@ namespace cppwin32
 
         void write_indent()
         {
-            for (int32_t i = 0; i < m_indent; i++)
+            // Written from a precomputed run of spaces rather than one level at a time.
+            static constexpr std::string_view spaces{ "                                                                " };
+            auto remaining = static_cast<size_t>((std::max)(m_indent, 0)) * 4;
+
+            while (remaining != 0)
             {
-                writer_base<T>::write_impl("    ");
+                auto const count = (std::min)(remaining, spaces.size());
+                writer_base<T>::write_impl(spaces.substr(0, count));
+                remaining -= count;
             }
         }
 
         void write_impl(std::string_view const& value)
         {
-            std::string_view::size_type current_pos{ 0 };
-            auto on_new_line = writer_base<T>::back() == '\n';
-
-            while (true)
+            // Without indentation, or without any newline to indent after, the whole
+            // fragment is appended at once.
+            if (m_indent <= 0 || value.empty())
             {
-                const auto pos = value.find('\n', current_pos);
-
-                if (pos == std::string_view::npos)
-                {
-                    if (current_pos < value.size())
-                    {
-                        if (on_new_line)
-                        {
-                            write_indent();
-                        }
-
-                        writer_base<T>::write_impl(value.substr(current_pos));
-                    }
+                writer_base<T>::write_impl(value);
+                return;
+            }
 
-                    return;
-                }
+            auto first = value.data();
+            auto const last = first + value.size();
+            auto on_new_line = writer_base<T>::back() == '\n';
 
-                auto current_line = value.substr(current_pos, pos - current_pos + 1);
-                auto empty_line = current_line[0] == '\n';
+            while (first != last)
+            {
+                auto const newline = static_cast<char const*>(memchr(first, '\n', last - first));
+                auto const line_last = newline ? newline + 1 : last;
 
-                if (on_new_line && !empty_line)
+                if (on_new_line && *first != '\n')
                 {
                     write_indent();
                 }
 
-                writer_base<T>::write_impl(current_line);
-
-                on_new_line = true;
-                current_pos = pos + 1;
+                writer_base<T>::write_impl(std::string_view{ first, static_cast<size_t>(line_last - first) });
+                on_new_line = newline != nullptr;
+                first = line_last;
             }
         }
 
         void write_impl(char const value)
         {
-            if (writer_base<T>::back() == '\n' && value != '\n')
+            if (m_indent > 0 && value != '\n' && writer_base<T>::back() == '\n')
             {
                 write_indent();
             }
@@ -378,7 +739,7 @@ namespace cppwin32
         }
 
         template <typename... Args>
-        std::string write_temp(std::string_view const& value, Args const& ... args)
+        std::string_view write_temp(format_string<std::type_identity_t<Args>...> const& value, Args const& ... args)
         {
             auto restore_indent = m_indent;
             m_indent = 0;
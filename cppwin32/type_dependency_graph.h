@@ -152,5 +152,251 @@ namespace cppwin32
             c(v.first);
         }
     };
+
+    // Groups the types of a type_dependency_graph into units of namespaces, each written as one
+    // definitions header. Namespaces whose types depend on each other, directly or through other
+    // namespaces, share a unit, so that the headers can include each other without cycles. A
+    // unit is named after the first of its namespaces.
+    struct definition_units
+    {
+        struct unit
+        {
+            std::vector<TypeDef> types; // in dependency order
+            std::set<std::string_view> depends; // the other units that these types need
+        };
+
+        std::map<std::string_view, std::string_view> names; // by namespace
+        std::map<std::string_view, unit> units;
+
+        explicit definition_units(type_dependency_graph& graph)
+        {
+            for (auto&& [type, node] : graph.graph)
+            {
+                auto& edges = m_edges[get_namespace(type)];
+
+                for (auto&& edge : node.edges)
+                {
+                    edges.insert(get_namespace(edge));
+                }
+            }
+
+            for (auto&& [ns, edges] : m_edges)
+            {
+                if (!m_visits.contains(ns))
+                {
+                    visit(ns);
+                }
+            }
+
+            graph.walk_graph([&](TypeDef const& type)
+                {
+                    if (!is_nested(type))
+                    {
+                        units[names[type.TypeNamespace()]].types.push_back(type);
+                    }
+                });
+
+            for (auto&& [ns, edges] : m_edges)
+            {
+                auto const name = names[ns];
+
+                for (auto&& edge : edges)
+                {
+                    if (names[edge] != name)
+                    {
+                        units[name].depends.insert(names[edge]);
+                    }
+                }
+            }
+        }
+
+    private:
+
+        // Nested types are defined along with the type that encloses them.
+        static std::string_view get_namespace(TypeDef type)
+        {
+            while (is_nested(type))
+            {
+                type = type.EnclosingType();
+            }
+
+            return type.TypeNamespace();
+        }
+
+        struct visit_state
+        {
+            uint32_t index{};
+            uint32_t low_link{};
+            bool on_stack{};
+        };
+
+        // Tarjan's algorithm, over namespaces rather than types.
+        void visit(std::string_view const& ns)
+        {
+            auto& state = m_visits[ns];
+            state.index = state.low_link = static_cast<uint32_t>(m_visits.size());
+            state.on_stack = true;
+            m_stack.push_back(ns);
+
+            for (auto&& edge : m_edges[ns])
+            {
+                if (!m_visits.contains(edge))
+                {
+                    visit(edge);
+                    state.low_link = (std::min)(state.low_link, m_visits[edge].low_link);
+                }
+                else if (m_visits[edge].on_stack)
+                {
+                    state.low_link = (std::min)(state.low_link, m_visits[edge].index);
+                }
+            }
+
+            if (state.low_link != state.index)
+            {
+                return;
+            }
+
+            auto const first = std::find(m_stack.begin(), m_stack.end(), ns);
+            auto const name = *std::min_element(first, m_stack.end());
+
+            for (auto member = first; member != m_stack.end(); ++member)
+            {
+                names[*member] = name;
+                m_visits[*member].on_stack = false;
+            }
+
+            m_stack.erase(first, m_stack.end());
+        }
+
+        std::map<std::string_view, std::set<std::string_view>> m_edges;
+        std::map<std::string_view, visit_state> m_visits;
+        std::vector<std::string_view> m_stack;
+    };
+
+    // The types, functions and constants that -roots needs. Unlike type_dependency_graph, which
+    // only tracks the types that must be defined first, this follows every reference, including
+    // pointers and signatures, as a type that is only declared must still be generated.
+    struct type_closure
+    {
+        std::set<TypeDef> types;
+        std::set<MethodDef> functions;
+        std::set<Field> constants;
+
+        explicit type_closure(cache const& c) : m_cache(c)
+        {
+        }
+
+        void add_type(TypeDef const& type)
+        {
+            if (!types.insert(type).second)
+            {
+                return;
+            }
+
+            // Nested types are written along with the type that encloses them.
+            if (is_nested(type))
+            {
+                add_type(type.EnclosingType());
+            }
+
+            m_pending.push_back(type);
+        }
+
+        void add_function(MethodDef const& method)
+        {
+            if (functions.insert(method).second)
+            {
+                add_signature(method);
+            }
+        }
+
+        void add_constant(Field const& field)
+        {
+            constants.insert(field);
+        }
+
+        // Visits the types added so far, and the types that they add in turn.
+        void complete()
+        {
+            while (!m_pending.empty())
+            {
+                auto const type = m_pending.back();
+                m_pending.pop_back();
+
+                switch (get_category(type))
+                {
+                case category::struct_type:
+                    for (auto&& field : type.FieldList())
+                    {
+                        add_type_sig(field.Signature().Type());
+                    }
+
+                    for (auto&& nested_type : m_cache.nested_types(type))
+                    {
+                        add_type(nested_type);
+                    }
+                    break;
+                case category::delegate_type:
+                    add_signature(get_delegate_method(type));
+                    break;
+                case category::interface_type:
+                    if (auto const base_index = get_base_interface(type))
+                    {
+                        add_type_index(base_index);
+                    }
+
+                    for (auto&& method : type.MethodList())
+                    {
+                        add_signature(method);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+    private:
+
+        void add_type_index(coded_index<TypeDefOrRef> const& index)
+        {
+            if (index.type() == TypeDefOrRef::TypeSpec)
+            {
+                return;
+            }
+
+            // Types defined outside of the cache are forward declared instead.
+            if (auto const type = find(index))
+            {
+                add_type(type);
+            }
+        }
+
+        void add_type_sig(TypeSig const& signature)
+        {
+            if (auto const index = std::get_if<coded_index<TypeDefOrRef>>(&signature.Type()))
+            {
+                add_type_index(*index);
+            }
+        }
+
+        void add_signature(MethodDef const& method)
+        {
+            method_signature signature{ method };
+
+            if (signature.return_signature())
+            {
+                add_type_sig(signature.return_signature().Type());
+            }
+
+            for (auto&& [param, param_signature] : signature.params())
+            {
+                add_type_sig(param_signature->Type());
+            }
+        }
+
+        cache const& m_cache;
+        std::vector<TypeDef> m_pending;
+    };
 }
 
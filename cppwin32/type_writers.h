@@ -25,14 +25,27 @@ namespace cppwin32
     {
         using writer_base<writer>::write;
 
+        // Atoms are numbered in string order within a cache, so comparing atoms from the same
+        // cache orders the types by name.
         struct depends_compare
         {
-            bool operator()(TypeDef const& left, TypeDef const& right) const
-            {
-                return left.TypeName() < right.TypeName();
-            }
-            bool operator()(TypeRef const& left, TypeRef const& right) const
+            template <typename T>
+            bool operator()(T const& left, T const& right) const
             {
+                auto const left_atom = left.TypeNameAtom();
+                auto const right_atom = right.TypeNameAtom();
+
+                if (left_atom && right_atom)
+                {
+                    auto const same_cache = left.get_database().shares_atoms(right.get_database());
+                    XLANG_ASSERT(same_cache);
+
+                    if (same_cache)
+                    {
+                        return left_atom < right_atom;
+                    }
+                }
+
                 return left.TypeName() < right.TypeName();
             }
         };
@@ -43,6 +56,8 @@ namespace cppwin32
         bool consume_types{};
         std::map<std::string_view, std::set<TypeDef, depends_compare>> depends;
         std::map<std::string_view, std::set<TypeRef, depends_compare>> extern_depends;
+        header_report::declaration_counts declarations{};
+        std::vector<std::string> includes;
 
         template<typename T>
         struct member_value_guard
@@ -81,13 +96,18 @@ namespace cppwin32
 
         void write_root_include(std::string_view const& include)
         {
-            auto format = R"(#include %win32/%.h%
+            constexpr auto format = R"(#include %win32/%.h%
 )";
 
             write(format,
                 settings.brackets ? '<' : '\"',
                 include,
                 settings.brackets ? '>' : '\"');
+
+            if (report.enabled())
+            {
+                includes.push_back(std::string{ include } + ".h");
+            }
         }
 
         void add_depends(TypeDef const& type)
@@ -153,18 +173,23 @@ namespace cppwin32
             }
         }
 
-        void write_code(std::string_view const& value)
+        void write_code(std::string_view value)
         {
-            for (auto&& c : value)
+            // Runs between dots are appended in one piece rather than a character at a time.
+            for (auto dot = value.find('.'); dot != std::string_view::npos; dot = value.find('.'))
             {
-                if (c == '.')
-                {
-                    write("::");
-                }
-                else
+                if (dot != 0)
                 {
-                    write(c);
+                    write(value.substr(0, dot));
                 }
+
+                write("::");
+                value.remove_prefix(dot + 1);
+            }
+
+            if (!value.empty())
+            {
+                write(value);
             }
         }
 
@@ -255,6 +280,7 @@ namespace cppwin32
 
         void write(std::u16string_view const& str)
         {
+#if defined(_WIN32)
             auto const data = reinterpret_cast<wchar_t const*>(str.data());
             auto const size = ::WideCharToMultiByte(CP_UTF8, 0, data, static_cast<int32_t>(str.size()), nullptr, 0, nullptr, nullptr);
             if (size == 0)
@@ -264,6 +290,45 @@ namespace cppwin32
             std::string result(size, '?');
             ::WideCharToMultiByte(CP_UTF8, 0, data, static_cast<int32_t>(str.size()), result.data(), size, nullptr, nullptr);
             write(result);
+#else
+            std::string result;
+            result.reserve(str.size());
+
+            for (size_t i{}; i != str.size(); ++i)
+            {
+                uint32_t c = str[i];
+
+                if (c >= 0xD800 && c < 0xDC00 && i + 1 != str.size() && str[i + 1] >= 0xDC00 && str[i + 1] < 0xE000)
+                {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (str[++i] - 0xDC00);
+                }
+
+                if (c < 0x80)
+                {
+                    result += static_cast<char>(c);
+                }
+                else if (c < 0x800)
+                {
+                    result += static_cast<char>(0xC0 | (c >> 6));
+                    result += static_cast<char>(0x80 | (c & 0x3F));
+                }
+                else if (c < 0x10000)
+                {
+                    result += static_cast<char>(0xE0 | (c >> 12));
+                    result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (c & 0x3F));
+                }
+                else
+                {
+                    result += static_cast<char>(0xF0 | (c >> 18));
+                    result += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                    result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (c & 0x3F));
+                }
+            }
+
+            write(result);
+#endif
         }
 
         void write(TypeDef const& type)
@@ -429,7 +494,21 @@ namespace cppwin32
             }
 
             filename += ".h";
-            flush_to_file(filename);
+            save_file(filename);
+        }
+
+        void add_declaration(declaration_kind const kind) noexcept
+        {
+            ++declarations[static_cast<size_t>(kind)];
+        }
+
+        void save_file(std::string const& filename)
+        {
+            manifest.add_file(filename);
+            auto const bytes = size();
+            report.add(filename, bytes, declarations, std::move(includes));
+            auto span = profile.measure("flush", filename);
+            profile.add_file(bytes, flush_to_file(filename));
         }
     };
 }
\ No newline at end of file
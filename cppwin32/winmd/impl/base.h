@@ -14,18 +14,28 @@
 #include <stdexcept>
 #include <assert.h>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <set>
+#include <shared_mutex>
+#include <span>
 #include <filesystem>
 
 #if defined(_DEBUG)
@@ -68,5 +78,34 @@ namespace winmd
         {
             return 0 == value.compare(0, match.size(), match);
         }
+
+        // Hashes eight bytes at a time, for keys such as namespaces that are long and share long
+        // prefixes, and for whole files.
+        inline uint64_t hash_bytes(void const* const bytes, size_t size) noexcept
+        {
+            constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+            auto data = static_cast<uint8_t const*>(bytes);
+            uint64_t value = size * multiplier;
+
+            while (size >= 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, data, 8);
+                value = (value ^ word) * multiplier;
+                value ^= value >> 29;
+                data += 8;
+                size -= 8;
+            }
+
+            if (size)
+            {
+                uint64_t word{};
+                std::memcpy(&word, data, size);
+                value = (value ^ word) * multiplier;
+                value ^= value >> 29;
+            }
+
+            return value;
+        }
     }
 }
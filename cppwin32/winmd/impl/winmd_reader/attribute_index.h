@@ -0,0 +1,182 @@
+namespace winmd::impl
+{
+    struct attribute_registry
+    {
+        uint32_t intern(std::string_view const& type_namespace, std::string_view const& type_name)
+        {
+            std::pair<std::string_view, std::string_view> const key{ type_namespace, type_name };
+
+            {
+                std::shared_lock guard(m_lock);
+                auto position = m_ids.find(key);
+
+                if (position != m_ids.end())
+                {
+                    return position->second;
+                }
+            }
+
+            std::unique_lock guard(m_lock);
+            auto [position, added] = m_ids.try_emplace({ std::string{ type_namespace }, std::string{ type_name } }, static_cast<uint32_t>(m_names.size()));
+
+            if (added)
+            {
+                m_names.push_back(&position->first);
+                m_count.store(static_cast<uint32_t>(m_names.size()), std::memory_order_release);
+            }
+
+            return position->second;
+        }
+
+        std::optional<uint32_t> find(std::string_view const& type_namespace, std::string_view const& type_name)
+        {
+            std::shared_lock guard(m_lock);
+            auto position = m_ids.find(std::pair<std::string_view, std::string_view>{ type_namespace, type_name });
+
+            if (position == m_ids.end())
+            {
+                return {};
+            }
+
+            return position->second;
+        }
+
+        // The number of names registered so far, which only grows.
+        uint32_t count() const noexcept
+        {
+            return m_count.load(std::memory_order_acquire);
+        }
+
+        std::pair<std::string, std::string> const& name(uint32_t const id)
+        {
+            std::shared_lock guard(m_lock);
+            return *m_names.at(id);
+        }
+
+    private:
+
+        struct name_less
+        {
+            using is_transparent = void;
+
+            template <typename Left, typename Right>
+            bool operator()(Left const& left, Right const& right) const noexcept
+            {
+                return std::pair<std::string_view, std::string_view>{ left.first, left.second } <
+                    std::pair<std::string_view, std::string_view>{ right.first, right.second };
+            }
+        };
+
+        std::shared_mutex m_lock;
+        std::map<std::pair<std::string, std::string>, uint32_t, name_less> m_ids;
+        std::vector<std::pair<std::string, std::string> const*> m_names;
+        std::atomic<uint32_t> m_count{};
+    };
+
+    inline attribute_registry& get_attribute_registry()
+    {
+        static attribute_registry registry;
+        return registry;
+    }
+}
+
+namespace winmd::reader
+{
+    // Attribute types are interned process-wide, so that an attribute_id can be looked up once
+    // (typically into a function-local static) and then used with any database.
+    using attribute_id = uint32_t;
+
+    inline attribute_id intern_attribute(std::string_view const& type_namespace, std::string_view const& type_name)
+    {
+        return impl::get_attribute_registry().intern(type_namespace, type_name);
+    }
+
+    // Unlike intern_attribute, doesn't register the name. A name that was never registered isn't
+    // the type of any attribute in a cache, as loading a cache interns each of its attribute types.
+    // Each thread remembers what it has looked up, so that only the first lookup of a name takes
+    // the registry's lock. A name that wasn't found is looked up again once others are registered.
+    inline std::optional<attribute_id> find_attribute_id(std::string_view const& type_namespace, std::string_view const& type_name)
+    {
+        struct entry
+        {
+            std::string type_namespace;
+            std::string type_name;
+            uint32_t count{};
+            std::optional<attribute_id> id;
+        };
+
+        // A thread only ever asks about a handful of names, so a linear search is quickest.
+        thread_local std::vector<entry> ids;
+        auto& registry = impl::get_attribute_registry();
+
+        auto position = std::find_if(ids.begin(), ids.end(), [&](entry const& candidate)
+            {
+                return candidate.type_name == type_name && candidate.type_namespace == type_namespace;
+            });
+
+        if (position == ids.end())
+        {
+            position = ids.insert(ids.end(), { std::string{ type_namespace }, std::string{ type_name } });
+        }
+        else if (position->id || position->count == registry.count())
+        {
+            return position->id;
+        }
+
+        // The count is read first, so that a name registered meanwhile is found next time.
+        position->count = registry.count();
+        position->id = registry.find(type_namespace, type_name);
+        return position->id;
+    }
+
+    // Returns the row's attribute of the given type without comparing any strings. Databases
+    // that aren't owned by a cache fall back to scanning the row's attributes.
+    template <typename T>
+    CustomAttribute find_attribute(T const& row, attribute_id const id)
+    {
+        auto const& db = row.get_database();
+
+        if (auto index = db.get_attribute_index())
+        {
+            auto const& slots = index->parent_slots[static_cast<uint32_t>(index_tag_v<HasCustomAttribute, T>)];
+
+            if (row.index() >= slots.size() || id >= index->words * 64)
+            {
+                return {};
+            }
+
+            auto const parent = slots[row.index()];
+
+            if (parent == 0 || !(index->parent_bits[(parent - 1) * index->words + id / 64] & (1ull << (id % 64))))
+            {
+                return {};
+            }
+
+            auto const [first, last] = index->parent_ranges[parent - 1];
+
+            for (auto attribute = first; attribute != last; ++attribute)
+            {
+                if (index->ids[attribute] == id)
+                {
+                    return db.CustomAttribute[attribute];
+                }
+            }
+
+            return {};
+        }
+
+        auto const& [type_namespace, type_name] = impl::get_attribute_registry().name(id);
+
+        for (auto&& attribute : row.CustomAttribute())
+        {
+            auto pair = attribute.TypeNamespaceAndName();
+
+            if (pair.first == type_namespace && pair.second == type_name)
+            {
+                return attribute;
+            }
+        }
+
+        return {};
+    }
+}
@@ -7,64 +7,71 @@ namespace winmd::reader
         cache(cache const&) = delete;
         cache& operator=(cache const&) = delete;
 
+        // A span of the cache's own construction, exposed so that callers can profile loading.
+        struct phase
+        {
+            std::string_view name;
+            std::string_view detail;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        // A metadata file that the caller has already mapped and validated.
+        struct mapped_file
+        {
+            std::string path;
+            file_view view;
+        };
+
         template<typename C, typename T = typename C::value_type>
-        explicit cache(C const& files)
+        explicit cache(C const& files) : cache{ map_files(files) }
         {
-            for (auto&& file : files)
-            {
-                auto& db = m_databases.emplace_back(file, this);
+        }
 
-                for (auto&& type : db.TypeDef)
-                {
-                    if (type.Flags().value == 0 || is_nested(type))
-                    {
-                        continue;
-                    }
+        // The cache is built on at most the given number of threads, which defaults to the
+        // processor count.
+        explicit cache(std::vector<mapped_file>&& files, uint32_t const jobs = 0) :
+            m_jobs(jobs ? jobs : (std::max)(1u, std::thread::hardware_concurrency()))
+        {
+            load(std::move(files));
 
-                    auto& ns = m_namespaces[type.TypeNamespace()];
-                    ns.types.try_emplace(type.TypeName(), type);
-                }
+            auto const atoms_start = std::chrono::steady_clock::now();
+            atomize_strings();
+            m_phases.push_back({ "atoms"sv, {}, atoms_start, std::chrono::steady_clock::now() });
 
-                for (auto&& row : db.NestedClass)
-                {
-                    m_nested_types[row.EnclosingType()].push_back(row.NestedType());
-                }
-            }
+            auto const index_start = std::chrono::steady_clock::now();
+            std::vector<type_index::entry> entries;
 
             for (auto&&[namespace_name, members] : m_namespaces)
             {
                 for (auto&&[name, type] : members.types)
                 {
-                    switch (get_category(type))
-                    {
-                    case category::interface_type:
-                        members.interfaces.push_back(type);
-                        continue;
-                    case category::class_type:
-                        if (extends_type(type, "System"sv, "Attribute"sv))
-                        {
-                            members.attributes.push_back(type);
-                            continue;
-                        }
-                        members.classes.push_back(type);
-                        continue;
-                    case category::enum_type:
-                        members.enums.push_back(type);
-                        continue;
-                    case category::struct_type:
-                        if (get_attribute(type, "Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv))
-                        {
-                            members.contracts.push_back(type);
-                            continue;
-                        }
-                        members.structs.push_back(type);
-                        continue;
-                    case category::delegate_type:
-                        members.delegates.push_back(type);
-                        continue;
-                    }
+                    entries.push_back({ namespace_name, name, type });
                 }
             }
+
+            m_index.assign(std::move(entries));
+            m_phases.push_back({ "index"sv, {}, index_start, std::chrono::steady_clock::now() });
+
+            auto const type_refs_start = std::chrono::steady_clock::now();
+            resolve_type_refs();
+            m_phases.push_back({ "type refs"sv, {}, type_refs_start, std::chrono::steady_clock::now() });
+
+            auto const attributes_start = std::chrono::steady_clock::now();
+            index_attributes();
+            m_phases.push_back({ "attributes"sv, {}, attributes_start, std::chrono::steady_clock::now() });
+
+            auto const traits_start = std::chrono::steady_clock::now();
+            compute_type_traits();
+            m_phases.push_back({ "traits"sv, {}, traits_start, std::chrono::steady_clock::now() });
+
+            auto const signatures_start = std::chrono::steady_clock::now();
+            decode_method_signatures();
+            m_phases.push_back({ "signatures"sv, {}, signatures_start, std::chrono::steady_clock::now() });
+
+            auto const categorize_start = std::chrono::steady_clock::now();
+            categorize();
+            m_phases.push_back({ "categorize"sv, {}, categorize_start, std::chrono::steady_clock::now() });
         }
 
         explicit cache(std::string const& file) : cache{ std::vector<std::string>{ file } }
@@ -73,33 +80,29 @@ namespace winmd::reader
 
         TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
         {
-            auto ns = m_namespaces.find(type_namespace);
-
-            if (ns == m_namespaces.end())
-            {
-                return {};
-            }
-
-            auto type = ns->second.types.find(type_name);
-
-            if (type == ns->second.types.end())
+            if (m_count_finds)
             {
-                return {};
+                m_find_calls.fetch_add(1, std::memory_order_relaxed);
             }
 
-            return type->second;
+            return m_index.find(type_namespace, type_name);
         }
 
         TypeDef find(std::string_view const& type_string) const
         {
-            auto pos = type_string.rfind('.');
+            if (m_count_finds)
+            {
+                m_find_calls.fetch_add(1, std::memory_order_relaxed);
+            }
 
-            if (pos == std::string_view::npos)
+            auto type = m_index.find(type_string);
+
+            if (!type && type_string.find('.') == std::string_view::npos)
             {
                 impl::throw_invalid("Type '", type_string, "' is missing a namespace qualifier");
             }
 
-            return find(type_string.substr(0, pos), type_string.substr(pos + 1, type_string.size()));
+            return type;
         }
 
         TypeDef find_required(std::string_view const& type_namespace, std::string_view const& type_name) const
@@ -116,14 +119,14 @@ namespace winmd::reader
 
         TypeDef find_required(std::string_view const& type_string) const
         {
-            auto pos = type_string.rfind('.');
+            auto definition = find(type_string);
 
-            if (pos == std::string_view::npos)
+            if (!definition)
             {
-                impl::throw_invalid("Type '", type_string, "' is missing a namespace qualifier");
+                impl::throw_invalid("Type '", type_string, "' could not be found");
             }
 
-            return find_required(type_string.substr(0, pos), type_string.substr(pos + 1, type_string.size()));
+            return definition;
         }
 
         auto const& databases() const noexcept
@@ -136,6 +139,27 @@ namespace winmd::reader
             return m_namespaces;
         }
 
+        atom_table const& atoms() const noexcept
+        {
+            return m_atoms;
+        }
+
+        auto const& phases() const noexcept
+        {
+            return m_phases;
+        }
+
+        // Counting is off by default as the shared counter is contended when find is called from many threads.
+        void count_finds(bool const enable) noexcept
+        {
+            m_count_finds = enable;
+        }
+
+        uint64_t find_calls() const noexcept
+        {
+            return m_find_calls.load(std::memory_order_relaxed);
+        }
+
         void remove_type(std::string_view const& ns, std::string_view const& name)
         {
             auto m = m_namespaces.find(ns);
@@ -165,18 +189,31 @@ namespace winmd::reader
             remove(members.delegates, name);
         }
 
-        std::vector<TypeDef> const& nested_types(TypeDef const& enclosing_type) const
+        // The TypeRefs that no database in the cache defines, other than nested types.
+        std::vector<TypeRef> const& extern_type_refs() const noexcept
         {
-            auto it = m_nested_types.find(enclosing_type);
-            if (it != m_nested_types.end())
-            {
-                return it->second;
-            }
-            else
-            {
-                static const std::vector<TypeDef> empty;
-                return empty;
-            }
+            return m_extern_type_refs;
+        }
+
+        // Encodes and decodes a resolved TypeRef target; see database::get_type_ref_target.
+        static uint64_t get_target(TypeDef const& type) noexcept
+        {
+            return (static_cast<uint64_t>(type.get_database().m_ordinal) << 32) | (type.index() + 1);
+        }
+
+        TypeDef get_type(uint64_t const target) const noexcept
+        {
+            return m_ordinals[target >> 32]->TypeDef[static_cast<uint32_t>(target) - 1];
+        }
+
+        std::span<TypeDef const> nested_types(TypeDef const& enclosing_type) const noexcept
+        {
+            return enclosing_type.get_database().get_nested_types(enclosing_type.index());
+        }
+
+        TypeDef find_nested(TypeDef const& enclosing_type, std::string_view const& type_name) const noexcept
+        {
+            return m_nested_index.find(enclosing_type, type_name);
         }
 
         struct namespace_members
@@ -195,8 +232,43 @@ namespace winmd::reader
 
     private:
 
+        template <typename C>
+        static std::vector<mapped_file> map_files(C const& files)
+        {
+            std::vector<mapped_file> result;
+
+            for (auto&& file : files)
+            {
+                std::string_view const path = file;
+                file_view view{ path };
+                view.advise(file_view::access::will_need);
+                result.push_back({ std::string{ path }, std::move(view) });
+            }
+
+            return result;
+        }
+
+        void load(std::vector<mapped_file>&& files);
+        void atomize_strings();
+        void resolve_type_refs();
+        void index_attributes();
+        void compute_type_traits();
+        void decode_method_signatures();
+        void categorize();
+
+        template <typename F>
+        void parallel_for(size_t const count, F&& callback) const;
+
         std::list<database> m_databases;
+        std::vector<database*> m_ordinals;
+        std::vector<TypeRef> m_extern_type_refs;
         std::map<std::string_view, namespace_members> m_namespaces;
-        std::map<TypeDef, std::vector<TypeDef>> m_nested_types;
+        type_index m_index;
+        nested_type_index m_nested_index;
+        atom_table m_atoms;
+        std::vector<phase> m_phases;
+        uint32_t m_jobs{ 1 };
+        bool m_count_finds{};
+        mutable std::atomic<uint64_t> m_find_calls{};
     };
 }
\ No newline at end of file
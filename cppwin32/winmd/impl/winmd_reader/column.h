@@ -368,6 +368,23 @@ namespace winmd::reader
         return equal_range(get_database().get_table<reader::CustomAttribute>(), coded_index<HasCustomAttribute>());
     }
 
+    inline auto MethodDef::ImplMap() const
+    {
+        auto const range = equal_range(get_database().ImplMap, coded_index<MemberForwarded>());
+        reader::ImplMap result;
+        if (range.first != range.second)
+        {
+            XLANG_ASSERT(range.second - range.first == 1);
+            result = range.first;
+        }
+        return result;
+    }
+
+    inline ModuleRef ImplMap::ImportScope() const
+    {
+        return get_target_row<reader::ModuleRef>(3);
+    }
+
     inline auto Field::CustomAttribute() const
     {
         return equal_range(get_database().get_table<reader::CustomAttribute>(), coded_index<HasCustomAttribute>());
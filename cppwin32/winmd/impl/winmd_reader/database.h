@@ -25,6 +25,43 @@ namespace winmd::reader
 {
     struct cache;
 
+    // Properties of a TypeDef that the owning cache computes once when it is loaded.
+    struct type_traits
+    {
+        uint8_t category{};
+        bool com_interface{};
+        bool union_type{};
+        bool nested{};
+        uint32_t guid_attribute{}; // CustomAttribute row of the GuidAttribute plus one, or zero
+    };
+
+    // Maps each row with custom attributes to its range of CustomAttribute rows, and to a bitset
+    // of the interned attribute types in that range. Built by the owning cache.
+    struct attribute_index
+    {
+        uint32_t words{}; // bitset words per parent
+        std::vector<uint32_t> ids; // attribute_id of each CustomAttribute row
+        std::array<std::vector<uint32_t>, 32> parent_slots; // parent row, by HasCustomAttribute tag, to parent index plus one
+        std::vector<std::pair<uint32_t, uint32_t>> parent_ranges;
+        std::vector<uint64_t> parent_bits;
+    };
+
+    // The decoded signature of each MethodDef, with its Param rows matched to the signature's
+    // parameters. Built by the owning cache and then only read.
+    struct method_signatures
+    {
+        std::vector<std::optional<RetTypeSig>> return_types; // by MethodDef row
+        std::vector<uint32_t> param_offsets; // by MethodDef row, plus one for the end
+        std::vector<ParamSig> param_signatures; // every method's params, at its offset
+        std::vector<std::pair<Param, ParamSig const*>> params; // likewise
+        std::vector<Param> return_params; // by MethodDef row, empty if there is no row for the return value
+
+        std::span<ParamSig const> get_params(uint32_t const row) const noexcept
+        {
+            return { param_signatures.data() + param_offsets[row], param_signatures.data() + param_offsets[row + 1] };
+        }
+    };
+
     struct database
     {
         database(database&&) = delete;
@@ -33,7 +70,11 @@ namespace winmd::reader
         static bool is_database(std::string_view const& path)
         {
             file_view file{ path };
+            return is_database(file);
+        }
 
+        static bool is_database(byte_view const& file)
+        {
             if (file.size() < sizeof(impl::image_dos_header))
             {
                 return false;
@@ -115,6 +156,13 @@ namespace winmd::reader
         }
 
         explicit database(std::string_view const& path, cache const* cache = nullptr) : m_view{ path }, m_path{ path }, m_cache{ cache }
+        {
+            m_view.advise(file_view::access::will_need);
+            initialize();
+        }
+
+        // Takes a file that has already been mapped, such as one checked with is_database.
+        database(file_view&& file, std::string_view const& path, cache const* cache = nullptr) : m_view{ std::move(file) }, m_path{ path }, m_cache{ cache }
         {
             initialize();
         }
@@ -171,8 +219,54 @@ namespace winmd::reader
             return m_path;
         }
 
+        // Returns nullptr if the database isn't owned by a cache.
+        attribute_index const* get_attribute_index() const noexcept
+        {
+            return m_attribute_index.words ? &m_attribute_index : nullptr;
+        }
+
+        // The types nested directly in the given TypeDef row, in NestedClass order. Empty if the
+        // database isn't owned by a cache.
+        std::span<reader::TypeDef const> get_nested_types(uint32_t const row) const noexcept
+        {
+            if (m_nested_offsets.empty())
+            {
+                return {};
+            }
+
+            return { m_nested_types.data() + m_nested_offsets[row], m_nested_types.data() + m_nested_offsets[row + 1] };
+        }
+
+        // The memoized resolution of a TypeRef row, or nullptr if the database isn't owned by a
+        // cache. Holds zero until the row is resolved, type_ref_extern if no database in the
+        // cache defines the type, and otherwise the defining database's ordinal in the high 32
+        // bits and its TypeDef row plus one in the low 32 bits.
+        std::atomic<uint64_t>* get_type_ref_target(uint32_t const row) const noexcept
+        {
+            return m_type_ref_targets ? &m_type_ref_targets[row] : nullptr;
+        }
+
+        static constexpr uint64_t type_ref_extern = UINT64_MAX;
+
+        // Returns nullptr if the database isn't owned by a cache.
+        reader::method_signatures const* get_method_signatures() const noexcept
+        {
+            return m_method_signatures.param_offsets.empty() ? nullptr : &m_method_signatures;
+        }
+
+        // Returns nullptr if the database isn't owned by a cache.
+        type_traits const* get_type_traits(uint32_t const row) const noexcept
+        {
+            return m_type_traits.empty() ? nullptr : &m_type_traits[row];
+        }
+
         std::string_view get_string(uint32_t const index) const
         {
+            if (auto const atom = m_string_atoms.find(index))
+            {
+                return { reinterpret_cast<char const*>(m_strings.begin()) + index, (*m_atoms)[atom].size() };
+            }
+
             auto view = m_strings.seek(index);
             auto last = std::find(view.begin(), view.end(), 0);
 
@@ -184,6 +278,35 @@ namespace winmd::reader
             return { reinterpret_cast<char const*>(view.begin()), static_cast<uint32_t>(last - view.begin()) };
         }
 
+        // Returns zero if the database isn't owned by a cache, or if no name in the cache has the
+        // string's value.
+        string_atom get_string_atom(uint32_t const index) const
+        {
+            if (!m_atoms)
+            {
+                return {};
+            }
+
+            if (auto const atom = m_string_atoms.find(index))
+            {
+                return atom;
+            }
+
+            return m_atoms->find(get_string(index));
+        }
+
+        // Atoms are numbered per cache, so two atoms can only be compared if their databases share it.
+        bool shares_atoms(database const& other) const noexcept
+        {
+            return m_atoms == other.m_atoms;
+        }
+
+        // Returns zero if the database isn't owned by a cache, or if no name in the cache has the value.
+        string_atom find_string_atom(std::string_view const& value) const noexcept
+        {
+            return m_atoms ? m_atoms->find(value) : string_atom{};
+        }
+
         byte_view get_blob(uint32_t const index) const
         {
             auto view = m_blobs.seek(index);
@@ -531,8 +654,25 @@ namespace winmd::reader
         byte_view m_blobs;
         byte_view m_guids;
         cache const* m_cache;
+        std::vector<type_traits> m_type_traits;
+        std::unique_ptr<std::atomic<uint64_t>[]> m_type_ref_targets;
+        reader::method_signatures m_method_signatures;
+        uint32_t m_ordinal{}; // position in the owning cache
+        std::vector<reader::TypeDef> m_nested_types; // grouped by enclosing type
+        std::vector<uint32_t> m_nested_offsets; // by TypeDef row, plus one for the end
+        attribute_index m_attribute_index;
+        atom_table const* m_atoms{};
+        string_atom_map m_string_atoms;
+
+        friend struct cache;
     };
 
+    template <typename Row>
+    inline string_atom row_base<Row>::get_string_atom(uint32_t const column) const
+    {
+        return get_database().get_string_atom(m_table->get_value<uint32_t>(m_index, column));
+    }
+
     template <typename Row>
     inline byte_view row_base<Row>::get_blob(uint32_t const column) const
     {
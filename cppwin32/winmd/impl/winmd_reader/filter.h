@@ -27,6 +27,16 @@ namespace winmd::reader
 
         bool includes(TypeDef const& type) const
         {
+            if (m_rules.empty())
+            {
+                return true;
+            }
+
+            if (auto const atom = type.TypeNamespaceAtom())
+            {
+                return includes(get_namespace_rules(atom, type.TypeNamespace()), type.TypeName());
+            }
+
             return includes(type.TypeNamespace(), type.TypeName());
         }
 
@@ -45,7 +55,7 @@ namespace winmd::reader
 
             for (auto&& type : types)
             {
-                if (includes(type.TypeNamespace(), type.TypeName()))
+                if (includes(type))
                 {
                     return true;
                 }
@@ -63,7 +73,7 @@ namespace winmd::reader
 
             for (auto&& type : members.types)
             {
-                if (includes(type.second.TypeNamespace(), type.second.TypeName()))
+                if (includes(type.second))
                 {
                     return true;
                 }
@@ -94,6 +104,72 @@ namespace winmd::reader
 
     private:
 
+        // The rules that apply to the types in one namespace. As longer rules are sorted first, the
+        // rules that reach into the type name are tried before any rule that only names a namespace.
+        struct namespace_rules
+        {
+            std::vector<std::pair<uint32_t, uint32_t>> name_rules; // rule, offset of the type name prefix
+            bool fallback{};
+        };
+
+        struct namespace_cache
+        {
+            std::shared_mutex lock;
+            std::unordered_map<string_atom, namespace_rules> rules;
+        };
+
+        // Matches each namespace against the rules once, so that the types in it only compare
+        // their names. The namespaces are keyed by atom, so a filter and its copies must only be
+        // used with the types of a single cache.
+        namespace_rules const& get_namespace_rules(string_atom const atom, std::string_view const& type_namespace) const
+        {
+            {
+                std::shared_lock guard(m_namespaces->lock);
+                auto position = m_namespaces->rules.find(atom);
+
+                if (position != m_namespaces->rules.end())
+                {
+                    return position->second;
+                }
+            }
+
+            namespace_rules result;
+
+            for (uint32_t index{}; index != m_rules.size(); ++index)
+            {
+                std::string_view const match = m_rules[index].first;
+
+                if (match.size() <= type_namespace.size())
+                {
+                    if (impl::starts_with(type_namespace, match))
+                    {
+                        result.fallback = m_rules[index].second;
+                        break;
+                    }
+                }
+                else if (impl::starts_with(match, type_namespace) && match[type_namespace.size()] == '.')
+                {
+                    result.name_rules.emplace_back(index, static_cast<uint32_t>(type_namespace.size() + 1));
+                }
+            }
+
+            std::unique_lock guard(m_namespaces->lock);
+            return m_namespaces->rules.try_emplace(atom, std::move(result)).first->second;
+        }
+
+        bool includes(namespace_rules const& rules, std::string_view const& type_name) const noexcept
+        {
+            for (auto&& [index, offset] : rules.name_rules)
+            {
+                if (impl::starts_with(type_name, std::string_view{ m_rules[index].first }.substr(offset)))
+                {
+                    return m_rules[index].second;
+                }
+            }
+
+            return rules.fallback;
+        }
+
         bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
         {
             if (m_rules.empty())
@@ -133,5 +209,6 @@ namespace winmd::reader
         }
 
         std::vector<std::pair<std::string, bool>> m_rules;
+        std::shared_ptr<namespace_cache> m_namespaces{ std::make_shared<namespace_cache>() };
     };
 }
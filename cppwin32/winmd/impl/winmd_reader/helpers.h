@@ -13,7 +13,9 @@ namespace winmd::reader
         return range.second - range.first;
     }
 
-    inline auto find(TypeRef const& type)
+    inline TypeDef find(TypeRef const& type);
+
+    inline TypeDef resolve(TypeRef const& type)
     {
         if (type.ResolutionScope().type() != ResolutionScope::TypeRef)
         {
@@ -26,41 +28,54 @@ namespace winmd::reader
             {
                 return TypeDef{};
             }
-            auto const& nested_types = enclosing_type.get_cache().nested_types(enclosing_type);
-            auto iter = std::find_if(nested_types.begin(), nested_types.end(),
-                [name = type.TypeName()](TypeDef const& arg)
-            {
-                return name == arg.TypeName();
-            });
-            if (iter == nested_types.end())
-            {
-                return TypeDef{};
-            }
-            return *iter;
+            return enclosing_type.get_cache().find_nested(enclosing_type, type.TypeName());
         }
     }
 
-    inline auto find_required(TypeRef const& type)
+    // Resolves a TypeRef once per row. Concurrent callers may both resolve a row that hasn't
+    // been filled in yet, but they store the same value.
+    inline TypeDef find(TypeRef const& type)
     {
-        if (type.ResolutionScope().type() != ResolutionScope::TypeRef)
+        auto const target = type.get_database().get_type_ref_target(type.index());
+
+        if (!target)
         {
-            return type.get_database().get_cache().find_required(type.TypeNamespace(), type.TypeName());
+            return resolve(type);
         }
-        else
+
+        auto value = target->load(std::memory_order_acquire);
+
+        if (value == 0)
         {
-            auto enclosing_type = find_required(type.ResolutionScope().TypeRef());
-            auto const& nested_types = enclosing_type.get_cache().nested_types(enclosing_type);
-            auto iter = std::find_if(nested_types.begin(), nested_types.end(),
-                [name = type.TypeName()](TypeDef const& arg)
-            {
-                return name == arg.TypeName();
-            });
-            if (iter == nested_types.end())
+            auto const definition = resolve(type);
+            value = definition ? cache::get_target(definition) : database::type_ref_extern;
+            target->store(value, std::memory_order_release);
+        }
+
+        if (value == database::type_ref_extern)
+        {
+            return {};
+        }
+
+        return type.get_database().get_cache().get_type(value);
+    }
+
+    inline TypeDef find_required(TypeRef const& type)
+    {
+        auto definition = find(type);
+
+        if (!definition)
+        {
+            if (type.ResolutionScope().type() == ResolutionScope::TypeRef)
             {
+                auto enclosing_type = find_required(type.ResolutionScope().TypeRef());
                 impl::throw_invalid("Type '", enclosing_type.TypeName(), ".", type.TypeName(), "' could not be found");
             }
-            return *iter;
+
+            impl::throw_invalid("Type '", type.TypeNamespace(), ".", type.TypeName(), "' could not be found");
         }
+
+        return definition;
     }
 
     inline TypeDef find(coded_index<TypeDefOrRef> const& type)
@@ -97,6 +112,600 @@ namespace winmd::reader
         }
     }
 
+    // Matches a method's Param rows to its signature's parameters, skipping the row for the
+    // return value if there is one. Returns that row, or an empty Param.
+    template <typename F>
+    Param match_params(MethodDef const& method, RetTypeSig const& return_type, std::span<ParamSig const> signatures, F&& add)
+    {
+        auto params = method.ParamList();
+        Param return_param;
+
+        if (return_type && params.first != params.second && params.first.Sequence() == 0)
+        {
+            return_param = params.first;
+            ++params.first;
+        }
+
+        for (uint32_t i{}; i != signatures.size(); ++i)
+        {
+            add(params.first + i, &signatures[i]);
+        }
+
+        return return_param;
+    }
+
+    // Decodes a method's signature blob as MethodDefSig does, but appends the params to the
+    // caller's array so that many methods can share one allocation.
+    inline RetTypeSig decode_method_signature(MethodDef const& method, std::vector<ParamSig>& params)
+    {
+        auto const& db = method.get_database();
+        auto data = db.get_blob(db.MethodDef.get_value<uint32_t>(method.index(), 4));
+        auto const calling_convention = uncompress_enum<CallingConvention>(data);
+
+        if (enum_mask(calling_convention, CallingConvention::Generic) == CallingConvention::Generic)
+        {
+            uncompress_unsigned(data);
+        }
+
+        auto const param_count = uncompress_unsigned(data);
+        RetTypeSig return_type{ &db.MethodDef, data };
+
+        if (param_count > data.size())
+        {
+            impl::throw_invalid("Invalid blob array size");
+        }
+
+        for (uint32_t count = 0; count < param_count; ++count)
+        {
+            params.emplace_back(&db.MethodDef, data);
+        }
+
+        return return_type;
+    }
+
+    inline bool compute_com_interface(TypeDef const& type)
+    {
+        if (type.TypeName() == "IUnknown")
+        {
+            return true;
+        }
+
+        for (auto&& base : type.InterfaceImpl())
+        {
+            auto base_type = find(base.Interface());
+
+            if (base_type && compute_com_interface(base_type))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Runs the callback for each index below the count on at most m_jobs threads, the calling
+    // thread among them. Each thread takes the next index from a shared counter, so that uneven
+    // items still balance across the threads.
+    template <typename F>
+    inline void cache::parallel_for(size_t const count, F&& callback) const
+    {
+        std::atomic<size_t> next{};
+
+        auto work = [&]
+        {
+            for (auto index = next++; index < count; index = next++)
+            {
+                callback(index);
+            }
+        };
+
+        std::vector<std::future<void>> tasks;
+
+        for (size_t i = 1; i < (std::min)(count, size_t{ m_jobs }); ++i)
+        {
+            tasks.push_back(std::async(std::launch::async, work));
+        }
+
+        work();
+
+        for (auto&& task : tasks)
+        {
+            task.get();
+        }
+    }
+
+    // Maps and scans the databases concurrently. Their types are then merged in the order of
+    // the files, so that the first definition of a type still wins.
+    inline void cache::load(std::vector<mapped_file>&& files)
+    {
+        struct loaded
+        {
+            std::list<database> db;
+            std::vector<TypeDef> types;
+            std::vector<nested_type_index::entry> nested;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        auto scan = [this](mapped_file& file)
+        {
+            loaded result;
+            result.start = std::chrono::steady_clock::now();
+            auto& db = result.db.emplace_back(std::move(file.view), file.path, this);
+
+            for (auto&& type : db.TypeDef)
+            {
+                if (type.Flags().value != 0 && !is_nested(type))
+                {
+                    result.types.push_back(type);
+                }
+            }
+
+            // Group the nested types by enclosing type, keeping NestedClass order within each group.
+            db.m_nested_offsets.assign(db.TypeDef.size() + 1, 0);
+
+            for (auto&& row : db.NestedClass)
+            {
+                ++db.m_nested_offsets[row.EnclosingType().index() + 1];
+            }
+
+            for (uint32_t row{}; row != db.TypeDef.size(); ++row)
+            {
+                db.m_nested_offsets[row + 1] += db.m_nested_offsets[row];
+            }
+
+            auto next = db.m_nested_offsets;
+            db.m_nested_types.resize(db.NestedClass.size());
+
+            for (auto&& row : db.NestedClass)
+            {
+                auto const enclosing_type = row.EnclosingType();
+                auto const nested_type = row.NestedType();
+                db.m_nested_types[next[enclosing_type.index()]++] = nested_type;
+                result.nested.push_back({ enclosing_type, nested_type });
+            }
+
+            result.end = std::chrono::steady_clock::now();
+            return result;
+        };
+
+        std::vector<loaded> results(files.size());
+
+        parallel_for(files.size(), [&](size_t const index)
+            {
+                results[index] = scan(files[index]);
+            });
+
+        std::vector<nested_type_index::entry> nested;
+
+        for (auto&& result : results)
+        {
+            m_databases.splice(m_databases.end(), result.db);
+            m_databases.back().m_ordinal = static_cast<uint32_t>(m_ordinals.size());
+            m_ordinals.push_back(&m_databases.back());
+
+            for (auto&& type : result.types)
+            {
+                m_namespaces[type.TypeNamespace()].types.try_emplace(type.TypeName(), type);
+            }
+
+            nested.insert(nested.end(), result.nested.begin(), result.nested.end());
+
+            m_phases.push_back({ "load"sv, m_databases.back().path(), result.start, result.end });
+        }
+
+        m_nested_index.assign(std::move(nested));
+    }
+
+    // Atomizes the strings that names refer to: the names and namespaces of TypeDefs and TypeRefs
+    // and the names of methods. Other strings, such as parameter names, are compared by value.
+    inline void cache::atomize_strings()
+    {
+        struct entry
+        {
+            std::string_view value;
+            database* db;
+            uint32_t offset;
+        };
+
+        // Finds each name string once, however many rows refer to it.
+        auto scan = [](database& db)
+        {
+            std::vector<entry> entries;
+
+            auto add = [&](auto const& table, uint32_t const column)
+            {
+                for (uint32_t row{}; row != table.size(); ++row)
+                {
+                    auto const offset = table.template get_value<uint32_t>(row, column);
+                    entries.push_back({ {}, &db, offset });
+                }
+            };
+
+            add(db.TypeDef, 1);
+            add(db.TypeDef, 2);
+            add(db.TypeRef, 1);
+            add(db.TypeRef, 2);
+            add(db.MethodDef, 3);
+
+            std::sort(entries.begin(), entries.end(), [](entry const& left, entry const& right)
+                {
+                    return left.offset < right.offset;
+                });
+
+            entries.erase(std::unique(entries.begin(), entries.end(), [](entry const& left, entry const& right)
+                {
+                    return left.offset == right.offset;
+                }), entries.end());
+
+            for (auto&& entry : entries)
+            {
+                entry.value = db.get_string(entry.offset);
+            }
+
+            return entries;
+        };
+
+        std::vector<std::vector<entry>> scans(m_ordinals.size());
+
+        parallel_for(m_ordinals.size(), [&](size_t const index)
+            {
+                scans[index] = scan(*m_ordinals[index]);
+            });
+
+        std::vector<entry> entries;
+
+        for (auto&& scan : scans)
+        {
+            entries.insert(entries.end(), scan.begin(), scan.end());
+        }
+
+        // Sorting by value numbers the atoms in string order and groups every occurrence of a string.
+        std::sort(entries.begin(), entries.end(), [](entry const& left, entry const& right)
+            {
+                return left.value < right.value;
+            });
+
+        std::vector<std::string_view> strings;
+        std::map<database*, std::vector<string_atom_map::entry>> atoms;
+
+        for (auto&& entry : entries)
+        {
+            if (strings.empty() || strings.back() != entry.value)
+            {
+                strings.push_back(entry.value);
+            }
+
+            atoms[entry.db].push_back({ entry.offset, static_cast<string_atom>(strings.size()) });
+        }
+
+        for (auto&& db : m_databases)
+        {
+            db.m_string_atoms.assign(atoms[&db]);
+            db.m_atoms = &m_atoms;
+        }
+
+        m_atoms.assign(std::move(strings));
+    }
+
+    // Resolves every TypeRef up front, so that the writers only read the memoized results. Each
+    // database's rows are split into chunks as for the type traits.
+    inline void cache::resolve_type_refs()
+    {
+        struct chunk
+        {
+            database const* db;
+            uint32_t first;
+            uint32_t last;
+        };
+
+        std::vector<chunk> chunks;
+        uint32_t const chunk_count = m_jobs;
+
+        for (auto&& db : m_databases)
+        {
+            db.m_type_ref_targets = std::make_unique<std::atomic<uint64_t>[]>(db.TypeRef.size());
+            uint32_t const chunk_size = (std::max)(1024u, (db.TypeRef.size() + chunk_count - 1) / chunk_count);
+
+            for (uint32_t first{}; first < db.TypeRef.size(); first += chunk_size)
+            {
+                chunks.push_back({ &db, first, (std::min)(first + chunk_size, db.TypeRef.size()) });
+            }
+        }
+
+        auto resolve = [](chunk const& chunk)
+        {
+            for (auto row = chunk.first; row != chunk.last; ++row)
+            {
+                reader::find(chunk.db->TypeRef[row]);
+            }
+        };
+
+        parallel_for(chunks.size(), [&](size_t const index)
+            {
+                resolve(chunks[index]);
+            });
+
+        for (auto&& db : m_databases)
+        {
+            for (auto&& type : db.TypeRef)
+            {
+                if (!is_nested(type) && db.get_type_ref_target(type.index())->load(std::memory_order_relaxed) == database::type_ref_extern)
+                {
+                    m_extern_type_refs.push_back(type);
+                }
+            }
+        }
+    }
+
+    // Decodes every method signature in parallel passes over chunks of rows. The first decodes
+    // the blobs, appending each chunk's params to an array of its own; the chunks' arrays are
+    // then moved into one array per database, and the last pass matches the Param rows.
+    inline void cache::decode_method_signatures()
+    {
+        struct chunk
+        {
+            database* db;
+            uint32_t first;
+            uint32_t last;
+            std::vector<ParamSig> params;
+        };
+
+        std::vector<chunk> chunks;
+        uint32_t const chunk_count = m_jobs;
+
+        for (auto&& db : m_databases)
+        {
+            auto& store = db.m_method_signatures;
+            store.return_types.resize(db.MethodDef.size());
+            store.param_offsets.assign(db.MethodDef.size() + 1, 0);
+            store.return_params.resize(db.MethodDef.size());
+            uint32_t const chunk_size = (std::max)(1024u, (db.MethodDef.size() + chunk_count - 1) / chunk_count);
+
+            for (uint32_t first{}; first < db.MethodDef.size(); first += chunk_size)
+            {
+                chunks.push_back({ &db, first, (std::min)(first + chunk_size, db.MethodDef.size()), {} });
+            }
+        }
+
+        auto run = [&](auto&& callback)
+        {
+            parallel_for(chunks.size(), [&](size_t const index)
+                {
+                    callback(chunks[index]);
+                });
+        };
+
+        // Each row's param count is recorded in the following row's offset until the offsets are summed.
+        run([](chunk& chunk)
+            {
+                auto& store = chunk.db->m_method_signatures;
+
+                for (auto row = chunk.first; row != chunk.last; ++row)
+                {
+                    auto const first = chunk.params.size();
+                    store.return_types[row].emplace(decode_method_signature(chunk.db->MethodDef[row], chunk.params));
+                    store.param_offsets[row + 1] = static_cast<uint32_t>(chunk.params.size() - first);
+                }
+            });
+
+        for (auto&& db : m_databases)
+        {
+            auto& store = db.m_method_signatures;
+
+            for (uint32_t row{}; row != db.MethodDef.size(); ++row)
+            {
+                store.param_offsets[row + 1] += store.param_offsets[row];
+            }
+
+            store.param_signatures.reserve(store.param_offsets.back());
+            store.params.resize(store.param_offsets.back());
+        }
+
+        for (auto&& chunk : chunks)
+        {
+            auto& signatures = chunk.db->m_method_signatures.param_signatures;
+            signatures.insert(signatures.end(), std::make_move_iterator(chunk.params.begin()), std::make_move_iterator(chunk.params.end()));
+            chunk.params = {};
+        }
+
+        run([](chunk const& chunk)
+            {
+                auto& store = chunk.db->m_method_signatures;
+
+                for (auto row = chunk.first; row != chunk.last; ++row)
+                {
+                    auto next = store.params.begin() + store.param_offsets[row];
+
+                    store.return_params[row] = match_params(chunk.db->MethodDef[row], *store.return_types[row], store.get_params(row), [&](Param const& param, ParamSig const* signature)
+                        {
+                            *next++ = { param, signature };
+                        });
+                }
+            });
+    }
+
+    inline void cache::index_attributes()
+    {
+        auto build = [](database& db)
+        {
+            attribute_index index;
+            std::map<std::pair<std::string_view, std::string_view>, attribute_id> local_ids;
+            attribute_id max_id{};
+            index.ids.reserve(db.CustomAttribute.size());
+
+            for (auto&& attribute : db.CustomAttribute)
+            {
+                auto const name = attribute.TypeNamespaceAndName();
+                auto position = local_ids.find(name);
+
+                if (position == local_ids.end())
+                {
+                    position = local_ids.emplace(name, intern_attribute(name.first, name.second)).first;
+                }
+
+                index.ids.push_back(position->second);
+                max_id = (std::max)(max_id, position->second);
+            }
+
+            index.words = max_id / 64 + 1;
+
+            // The CustomAttribute table is sorted by parent, so each parent's attributes are contiguous.
+            for (uint32_t row{}; row != db.CustomAttribute.size(); ++row)
+            {
+                auto const parent = db.CustomAttribute[row].Parent();
+                auto& slots = index.parent_slots[static_cast<uint32_t>(parent.type())];
+
+                if (slots.size() <= parent.index())
+                {
+                    slots.resize(parent.index() + 1);
+                }
+
+                auto& slot = slots[parent.index()];
+
+                if (slot == 0)
+                {
+                    index.parent_ranges.emplace_back(row, row);
+                    index.parent_bits.resize(index.parent_bits.size() + index.words);
+                    slot = static_cast<uint32_t>(index.parent_ranges.size());
+                }
+                else if (slot != index.parent_ranges.size())
+                {
+                    impl::throw_invalid("CustomAttribute table is not sorted by parent");
+                }
+
+                auto const id = index.ids[row];
+                index.parent_ranges.back().second = row + 1;
+                index.parent_bits[(slot - 1) * index.words + id / 64] |= 1ull << (id % 64);
+            }
+
+            db.m_attribute_index = std::move(index);
+        };
+
+        parallel_for(m_ordinals.size(), [&](size_t const index)
+            {
+                build(*m_ordinals[index]);
+            });
+    }
+
+    inline void cache::compute_type_traits()
+    {
+        struct chunk
+        {
+            database const* db;
+            type_traits* traits;
+            uint32_t first;
+            uint32_t last;
+        };
+
+        auto compute = [](chunk const& chunk)
+        {
+            for (auto row = chunk.first; row != chunk.last; ++row)
+            {
+                auto const type = chunk.db->TypeDef[row];
+                auto const guid = find_attribute(type, guid_attribute_id());
+                auto& result = chunk.traits[row];
+                result.category = static_cast<uint8_t>(compute_category(type));
+                result.com_interface = compute_com_interface(type);
+                result.union_type = type.Flags().Layout() == TypeLayout::ExplicitLayout;
+                result.nested = is_nested(type);
+                result.guid_attribute = guid ? guid.index() + 1 : 0;
+            }
+        };
+
+        // The traits are computed into separate arrays, as the helpers start reading them
+        // as soon as they are assigned to the databases.
+        std::vector<std::vector<type_traits>> results;
+        std::vector<chunk> chunks;
+        uint32_t const chunk_count = m_jobs;
+
+        for (auto&& db : m_databases)
+        {
+            auto& traits = results.emplace_back(db.TypeDef.size());
+            uint32_t const chunk_size = (std::max)(1024u, (db.TypeDef.size() + chunk_count - 1) / chunk_count);
+
+            for (uint32_t first{}; first < db.TypeDef.size(); first += chunk_size)
+            {
+                chunks.push_back({ &db, traits.data(), first, (std::min)(first + chunk_size, db.TypeDef.size()) });
+            }
+        }
+
+        parallel_for(chunks.size(), [&](size_t const index)
+            {
+                compute(chunks[index]);
+            });
+
+        auto result = results.begin();
+
+        for (auto&& db : m_databases)
+        {
+            db.m_type_traits = std::move(*result++);
+        }
+    }
+
+    // Each namespace is categorized independently, so the threads take the namespaces one at a
+    // time. Within a namespace the types are still visited in name order.
+    inline void cache::categorize()
+    {
+        auto const contract_attribute = intern_attribute("Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv);
+        std::vector<namespace_members*> namespaces;
+
+        for (auto&& [namespace_name, members] : m_namespaces)
+        {
+            namespaces.push_back(&members);
+        }
+
+        auto categorize = [&](size_t const index)
+        {
+            auto& members = *namespaces[index];
+
+            for (auto&& [name, type] : members.types)
+            {
+                switch (get_category(type))
+                {
+                case category::interface_type:
+                    members.interfaces.push_back(type);
+                    continue;
+                case category::class_type:
+                    if (extends_type(type, "System"sv, "Attribute"sv))
+                    {
+                        members.attributes.push_back(type);
+                        continue;
+                    }
+                    members.classes.push_back(type);
+                    continue;
+                case category::enum_type:
+                    members.enums.push_back(type);
+                    continue;
+                case category::struct_type:
+                    if (find_attribute(type, contract_attribute))
+                    {
+                        members.contracts.push_back(type);
+                        continue;
+                    }
+                    members.structs.push_back(type);
+                    continue;
+                case category::delegate_type:
+                    members.delegates.push_back(type);
+                    continue;
+                }
+            }
+        };
+
+        // Small inputs aren't worth a thread.
+        if (namespaces.size() < 64)
+        {
+            for (size_t index{}; index != namespaces.size(); ++index)
+            {
+                categorize(index);
+            }
+        }
+        else
+        {
+            parallel_for(namespaces.size(), categorize);
+        }
+    }
+
     inline bool is_const(ParamSig const& param)
     {
         auto is_type_const = [](auto&& type)
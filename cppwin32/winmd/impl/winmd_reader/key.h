@@ -162,6 +162,14 @@ namespace winmd::reader
     template <typename T>
     CustomAttribute get_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
     {
+        // Looking the id up compares the names, so callers on hot paths should instead call
+        // find_attribute with an id that they have looked up once.
+        if (row.get_database().get_attribute_index())
+        {
+            auto const id = find_attribute_id(type_namespace, type_name);
+            return id ? find_attribute(row, *id) : CustomAttribute{};
+        }
+
         for (auto&& attribute : row.CustomAttribute())
         {
             auto pair = attribute.TypeNamespaceAndName();
@@ -184,13 +192,34 @@ namespace winmd::reader
         delegate_type
     };
 
-    inline category get_category(TypeDef const& type)
+    inline attribute_id guid_attribute_id()
+    {
+        static attribute_id const id = intern_attribute("System.Runtime.InteropServices"sv, "GuidAttribute"sv);
+        return id;
+    }
+
+    inline CustomAttribute get_guid_attribute(TypeDef const& type)
     {
-        if (type.Flags().Semantics() == TypeSemantics::Interface || get_attribute(type, "System.Runtime.InteropServices"sv, "GuidAttribute"sv))
+        if (auto traits = type.get_database().get_type_traits(type.index()))
+        {
+            return traits->guid_attribute ? type.get_database().CustomAttribute[traits->guid_attribute - 1] : CustomAttribute{};
+        }
+
+        return find_attribute(type, guid_attribute_id());
+    }
+
+    inline category compute_category(TypeDef const& type)
+    {
+        if (type.Flags().Semantics() == TypeSemantics::Interface || get_guid_attribute(type))
         {
             return category::interface_type;
         }
 
+        if (!type.Extends())
+        {
+            return category::class_type;
+        }
+
         auto const& [extends_namespace, extends_name] = get_base_class_namespace_and_name(type);
 
         if (extends_name == "Enum"sv && extends_namespace == "System"sv)
@@ -210,4 +239,14 @@ namespace winmd::reader
 
         return category::class_type;
     }
+
+    inline category get_category(TypeDef const& type)
+    {
+        if (auto traits = type.get_database().get_type_traits(type.index()))
+        {
+            return static_cast<category>(traits->category);
+        }
+
+        return compute_category(type);
+    }
 }
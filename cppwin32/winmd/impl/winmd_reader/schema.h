@@ -20,6 +20,16 @@ namespace winmd::reader
             return get_string(2);
         }
 
+        auto TypeNameAtom() const
+        {
+            return get_string_atom(1);
+        }
+
+        auto TypeNamespaceAtom() const
+        {
+            return get_string_atom(2);
+        }
+
         auto CustomAttribute() const;
     };
 
@@ -61,6 +71,16 @@ namespace winmd::reader
             return get_string(2);
         }
 
+        auto TypeNameAtom() const
+        {
+            return get_string_atom(1);
+        }
+
+        auto TypeNamespaceAtom() const
+        {
+            return get_string_atom(2);
+        }
+
         auto Extends() const
         {
             return get_coded_index<TypeDefOrRef>(3);
@@ -106,6 +126,11 @@ namespace winmd::reader
             return get_string(3);
         }
 
+        auto NameAtom() const
+        {
+            return get_string_atom(3);
+        }
+
         MethodDefSig Signature() const
         {
             auto cursor = get_blob(4);
@@ -113,6 +138,7 @@ namespace winmd::reader
         }
 
         auto ParamList() const;
+        auto ImplMap() const;
         auto CustomAttribute() const;
         auto Parent() const;
         auto GenericParam() const;
@@ -417,12 +443,29 @@ namespace winmd::reader
     {
         using row_base::row_base;
 
+        auto Name() const
+        {
+            return get_string(0);
+        }
+
         auto CustomAttribute() const;
     };
 
     struct ImplMap : row_base<ImplMap>
     {
         using row_base::row_base;
+
+        auto MemberForwarded() const
+        {
+            return get_coded_index<reader::MemberForwarded>(1);
+        }
+
+        auto ImportName() const
+        {
+            return get_string(2);
+        }
+
+        reader::ModuleRef ImportScope() const;
     };
 
     struct FieldRVA : row_base<FieldRVA>
@@ -682,6 +725,16 @@ namespace winmd::reader
         return left < right.NestedType();
     }
 
+    inline bool operator<(coded_index<MemberForwarded> const& left, ImplMap const& right) noexcept
+    {
+        return left < right.MemberForwarded();
+    }
+
+    inline bool operator<(ImplMap const& left, coded_index<MemberForwarded> const& right) noexcept
+    {
+        return left.MemberForwarded() < right;
+    }
+
     inline bool operator<(coded_index<HasFieldMarshal> const& left, FieldMarshal const& right) noexcept
     {
         return left < right.Parent();
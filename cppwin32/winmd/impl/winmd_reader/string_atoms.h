@@ -0,0 +1,112 @@
+namespace winmd::reader
+{
+    // Identifies the contents of a #Strings heap entry across every database in a cache. Atoms are
+    // numbered in the lexicographic order of their strings, so comparing two atoms orders their
+    // strings as well. Zero means that the string has no atom and must be compared by value.
+    using string_atom = uint32_t;
+
+    struct atom_table
+    {
+        // Numbers the strings, which must be sorted and unique, from one.
+        void assign(std::vector<std::string_view>&& strings)
+        {
+            strings.insert(strings.begin(), std::string_view{});
+            m_strings = std::move(strings);
+        }
+
+        string_atom find(std::string_view const& value) const noexcept
+        {
+            if (m_strings.empty())
+            {
+                return {};
+            }
+
+            auto position = std::lower_bound(m_strings.begin() + 1, m_strings.end(), value);
+
+            if (position == m_strings.end() || *position != value)
+            {
+                return {};
+            }
+
+            return static_cast<string_atom>(position - m_strings.begin());
+        }
+
+        std::string_view operator[](string_atom const atom) const noexcept
+        {
+            return m_strings[atom];
+        }
+
+        size_t size() const noexcept
+        {
+            return m_strings.empty() ? 0 : m_strings.size() - 1;
+        }
+
+    private:
+
+        std::vector<std::string_view> m_strings;
+    };
+
+    // Maps the #Strings offsets that a database's names refer to onto their atoms, in an
+    // open-addressing table. Only those offsets are kept, rather than an entry per heap byte.
+    struct string_atom_map
+    {
+        struct entry
+        {
+            uint32_t offset{};
+            string_atom atom{}; // zero in an empty slot
+        };
+
+        void assign(std::vector<entry> const& entries)
+        {
+            size_t capacity = 16;
+
+            while (capacity < entries.size() * 2)
+            {
+                capacity *= 2;
+            }
+
+            m_slots.assign(capacity, entry{});
+            m_mask = capacity - 1;
+
+            for (auto&& value : entries)
+            {
+                auto position = slot(value.offset);
+
+                while (m_slots[position].atom && m_slots[position].offset != value.offset)
+                {
+                    position = (position + 1) & m_mask;
+                }
+
+                m_slots[position] = value;
+            }
+        }
+
+        string_atom find(uint32_t const offset) const noexcept
+        {
+            if (m_slots.empty())
+            {
+                return {};
+            }
+
+            for (auto position = slot(offset);; position = (position + 1) & m_mask)
+            {
+                auto const& value = m_slots[position];
+
+                if (!value.atom || value.offset == offset)
+                {
+                    return value.atom;
+                }
+            }
+        }
+
+    private:
+
+        size_t slot(uint32_t const offset) const noexcept
+        {
+            return static_cast<size_t>((offset * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+        }
+
+        std::vector<entry> m_slots;
+        size_t m_mask{};
+    };
+}
@@ -289,7 +289,7 @@ namespace winmd::reader
         reference operator--() noexcept
         {
             --m_index;
-            return *this;
+            return static_cast<reference>(*this);
         }
 
         value_type operator--(int) noexcept
@@ -376,6 +376,7 @@ namespace winmd::reader
         row_base() noexcept = default;
 
         std::string_view get_string(uint32_t const column) const;
+        string_atom get_string_atom(uint32_t const column) const;
         byte_view get_blob(uint32_t const column) const;
 
         template <typename T>
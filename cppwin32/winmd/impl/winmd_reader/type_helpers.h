@@ -32,6 +32,11 @@ namespace winmd::reader
 
     inline bool is_nested(TypeDef const& type)
     {
+        if (auto traits = type.get_database().get_type_traits(type.index()))
+        {
+            return traits->nested;
+        }
+
         const auto visibility = type.Flags().Visibility();
         return !(visibility == TypeVisibility::Public || visibility == TypeVisibility::NotPublic);
     }
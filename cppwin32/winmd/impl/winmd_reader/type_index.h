@@ -0,0 +1,184 @@
+namespace winmd::reader
+{
+    // Open-addressing hash table of entry indexes, keyed on hashes that the caller computes. The
+    // entries themselves are kept by the caller, which compares them to resolve collisions.
+    struct hash_slots
+    {
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        void assign(std::vector<uint64_t> const& hashes)
+        {
+            size_t capacity = 16;
+
+            // Keep the load factor at or below one half so that probe sequences stay short.
+            while (capacity < hashes.size() * 2)
+            {
+                capacity *= 2;
+            }
+
+            m_slots.assign(capacity, slot{});
+            m_mask = capacity - 1;
+
+            for (uint32_t index{}; index != hashes.size(); ++index)
+            {
+                auto position = static_cast<size_t>(hashes[index]) & m_mask;
+
+                while (m_slots[position].index != npos)
+                {
+                    position = (position + 1) & m_mask;
+                }
+
+                m_slots[position] = { hashes[index], index };
+            }
+        }
+
+        template <typename Equal>
+        uint32_t find(uint64_t const value, Equal&& equal) const noexcept
+        {
+            if (m_slots.empty())
+            {
+                return npos;
+            }
+
+            for (auto position = static_cast<size_t>(value) & m_mask;; position = (position + 1) & m_mask)
+            {
+                auto const& slot = m_slots[position];
+
+                if (slot.index == npos || (slot.hash == value && equal(slot.index)))
+                {
+                    return slot.index;
+                }
+            }
+        }
+
+    private:
+
+        struct slot
+        {
+            uint64_t hash{};
+            uint32_t index{ npos };
+        };
+
+        std::vector<slot> m_slots;
+        size_t m_mask{};
+    };
+
+    // Hash index over the non-nested types in a cache, keyed on the namespace and name. A
+    // "Namespace.Name" string is looked up directly by hashing the two parts either side of its
+    // last '.', without building substrings or a second lookup.
+    struct type_index
+    {
+        struct entry
+        {
+            std::string_view type_namespace;
+            std::string_view type_name;
+            TypeDef type;
+        };
+
+        static uint64_t hash(std::string_view const& text) noexcept
+        {
+            return impl::hash_bytes(text.data(), text.size());
+        }
+
+        static uint64_t hash(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+        {
+            auto value = (hash(type_namespace) ^ (hash(type_name) * 0xC2B2AE3D27D4EB4Full)) * 0x165667B19E3779F9ull;
+            return value ^ (value >> 32);
+        }
+
+        void assign(std::vector<entry>&& entries)
+        {
+            m_entries = std::move(entries);
+            std::vector<uint64_t> hashes;
+            hashes.reserve(m_entries.size());
+
+            for (auto&& entry : m_entries)
+            {
+                hashes.push_back(hash(entry.type_namespace, entry.type_name));
+            }
+
+            m_slots.assign(hashes);
+        }
+
+        TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            auto const index = m_slots.find(hash(type_namespace, type_name), [&](uint32_t const index)
+                {
+                    auto const& entry = m_entries[index];
+                    return entry.type_name == type_name && entry.type_namespace == type_namespace;
+                });
+
+            return index == hash_slots::npos ? TypeDef{} : m_entries[index].type;
+        }
+
+        TypeDef find(std::string_view const& full_name) const noexcept
+        {
+            auto const pos = full_name.rfind('.');
+
+            if (pos == std::string_view::npos)
+            {
+                return {};
+            }
+
+            return find(full_name.substr(0, pos), full_name.substr(pos + 1));
+        }
+
+        size_t size() const noexcept
+        {
+            return m_entries.size();
+        }
+
+    private:
+
+        std::vector<entry> m_entries;
+        hash_slots m_slots;
+    };
+
+    // Hash index over the nested types in a cache, keyed on the enclosing type and the name.
+    struct nested_type_index
+    {
+        static uint64_t hash(TypeDef const& enclosing_type, std::string_view const& type_name) noexcept
+        {
+            auto const database = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&enclosing_type.get_database()));
+            auto value = ((database ^ (static_cast<uint64_t>(enclosing_type.index()) << 3)) * 0x9E3779B97F4A7C15ull) ^ type_index::hash(type_name);
+            value *= 0x165667B19E3779F9ull;
+            return value ^ (value >> 32);
+        }
+
+        struct entry
+        {
+            TypeDef enclosing_type;
+            TypeDef type;
+        };
+
+        void assign(std::vector<entry>&& entries)
+        {
+            m_entries = std::move(entries);
+            std::vector<uint64_t> hashes;
+            hashes.reserve(m_entries.size());
+
+            for (auto&& entry : m_entries)
+            {
+                hashes.push_back(hash(entry.enclosing_type, entry.type.TypeName()));
+            }
+
+            m_slots.assign(hashes);
+        }
+
+        TypeDef find(TypeDef const& enclosing_type, std::string_view const& type_name) const noexcept
+        {
+            auto const index = m_slots.find(hash(enclosing_type, type_name), [&](uint32_t const index)
+                {
+                    auto const& entry = m_entries[index];
+                    return entry.enclosing_type == enclosing_type && entry.type.TypeName() == type_name;
+                });
+
+            return index == hash_slots::npos ? TypeDef{} : m_entries[index].type;
+        }
+
+    private:
+
+        std::vector<entry> m_entries;
+        hash_slots m_slots;
+    };
+}
@@ -161,7 +161,7 @@ namespace winmd::reader
 
         ~file_view() noexcept
         {
-            if (m_backed_by_file)
+            if (m_backed_by_file && begin())
             {
 #if defined(_WIN32)
                 UnmapViewOfFile(begin());
@@ -171,6 +171,43 @@ namespace winmd::reader
             }
         }
 
+        enum class access
+        {
+            normal,
+            sequential,
+            random,
+            will_need,
+        };
+
+        // Tells the OS how the mapping is about to be read. This is only a hint, so failures are ignored.
+        void advise(access const pattern) const noexcept
+        {
+            if (!m_backed_by_file || !size())
+            {
+                return;
+            }
+
+#if defined(_WIN32)
+            if (pattern == access::will_need)
+            {
+                WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(begin()), size() };
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            }
+#else
+            int advice = MADV_NORMAL;
+
+            switch (pattern)
+            {
+            case access::sequential: advice = MADV_SEQUENTIAL; break;
+            case access::random: advice = MADV_RANDOM; break;
+            case access::will_need: advice = MADV_WILLNEED; break;
+            default: break;
+            }
+
+            madvise(const_cast<uint8_t*>(begin()), size(), advice);
+#endif
+        }
+
     private:
 
         bool m_backed_by_file;
@@ -272,27 +309,28 @@ namespace winmd::reader
             auto const first{ static_cast<uint8_t const*>(MapViewOfFile(mapping.value, FILE_MAP_READ, 0, 0, 0)) };
             return{ first, first + size.QuadPart };
 #else
-            file_handle file{ open(c_str(path), O_RDONLY, 0) };
+            file_handle file{ open(impl::c_str(path), O_RDONLY, 0) };
             if (!file)
             {
-                throw_invalid("Could not open file '", path, "'");
+                impl::throw_invalid("Could not open file '", path, "'");
             }
 
             struct stat st;
             int ret = fstat(file.value, &st);
             if (ret < 0)
             {
-                throw_invalid("Could not open file '", path, "'");
+                impl::throw_invalid("Could not open file '", path, "'");
             }
             if (!st.st_size)
             {
                 return{};
             }
 
-            auto const first = static_cast<uint8_t const*>(mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, file.value, 0));
+            // Pages are read as they are touched, so that checking a file only reads its headers.
+            auto const first = static_cast<uint8_t const*>(mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, file.value, 0));
             if (first == MAP_FAILED)
             {
-                throw_invalid("Could not open file '", path, "'");
+                impl::throw_invalid("Could not open file '", path, "'");
             }
 
             return{ first, first + st.st_size };
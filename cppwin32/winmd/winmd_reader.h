@@ -3,6 +3,7 @@
 #include "impl/base.h"
 #include "impl/winmd_reader/pe.h"
 #include "impl/winmd_reader/view.h"
+#include "impl/winmd_reader/string_atoms.h"
 #include "impl/winmd_reader/enum.h"
 #include "impl/winmd_reader/enum_traits.h"
 #include "impl/winmd_reader/flags.h"
@@ -13,7 +14,9 @@
 #include "impl/winmd_reader/database.h"
 #include "impl/winmd_reader/column.h"
 #include "impl/winmd_reader/type_helpers.h"
+#include "impl/winmd_reader/attribute_index.h"
 #include "impl/winmd_reader/key.h"
+#include "impl/winmd_reader/type_index.h"
 #include "impl/winmd_reader/cache.h"
 #include "impl/winmd_reader/filter.h"
 #include "impl/winmd_reader/custom_attribute.h"